@@ -0,0 +1,3 @@
+#!/bin/bash
+
+make -s build/release/bench.exe && ./build/release/bench.exe "$@"
@@ -0,0 +1,423 @@
+/*
+   File: benchmark.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: Micro-benchmarks for the field kernels of the model. Each environment (the shipped ones or synthetic empty rooms) is prepared as a simulation would be, and every kernel is then timed in isolation. The results are written as CSV, one line per (environment, kernel).
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<dirent.h>
+#include<unistd.h>
+#include<sys/wait.h>
+
+#include"../headers/grid.h"
+#include"../headers/exit.h"
+#include"../headers/pedestrian.h"
+#include"../headers/initialization.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+#include"../headers/dynamic_field.h"
+#include"../headers/static_field.h"
+#include"../headers/fire_field.h"
+#include"../headers/fire_dynamics.h"
+#include"../headers/cell_graph.h"
+
+#define MIN_BENCHMARK_TIME 0.2 // Minimum time, in seconds, spent timing each kernel.
+#define MIN_REPETITIONS 3
+#define BENCHMARK_DENSITY 0.3 // Density of the pedestrians used by the vision benchmark.
+#define MAX_VISION_PEDESTRIANS 64 // The vision kernel is costly on large rooms, so only this many pedestrians are timed.
+#define INSERTION_DENSITY 0.9 // Density of the pedestrians inserted by the insertion benchmark, high enough to fill most of the room.
+
+typedef void (*Kernel_Setup)(); // Restores the inputs of a kernel that modifies them. Not timed.
+typedef void (*Kernel_Function)();
+
+typedef struct{
+    const char *name;
+    const char *item; // What is counted by the throughput ("cell" or "pedestrian").
+    Kernel_Setup setup;
+    Kernel_Function kernel;
+}Kernel_Benchmark;
+
+static Function_Status benchmark_environment(const char *environment);
+static Function_Status prepare_environment(const char *environment);
+static Function_Status add_synthetic_exit();
+static void add_synthetic_fire();
+static Function_Status prepare_fields();
+static void time_kernel(const char *environment, Kernel_Benchmark *benchmark);
+static double elapsed_nanoseconds(struct timespec start, struct timespec end);
+static int number_vision_pedestrians();
+
+static void static_field_kernel();
+static void composed_static_field_kernel();
+static void restore_composed_static_field();
+static void ignited_cells_removal_kernel();
+static void static_weight_kernel();
+static void fire_distance_kernel();
+static void restore_dynamic_field();
+static void decay_and_diffusion_kernel();
+static void ignition_epochs_kernel();
+static void pedestrian_vision_kernel();
+static void remove_pedestrians();
+static void pedestrian_insertion_kernel();
+
+static Kernel_Benchmark kernel_benchmarks[] = {
+    {"calculate_zheng_static_field", "cell", NULL, &static_field_kernel},
+    {"compose_zheng_static_field", "cell", NULL, &composed_static_field_kernel},
+    {"remove_ignited_cells_from_zheng_static_field", "cell", &restore_composed_static_field, &ignited_cells_removal_kernel},
+    {"calculate_static_weight", "cell", NULL, &static_weight_kernel},
+    {"calculate_distance_from_cells_to_fire", "cell", NULL, &fire_distance_kernel},
+    {"apply_decay_and_diffusion", "cell", &restore_dynamic_field, &decay_and_diffusion_kernel},
+    {"calculate_ignition_epochs", "cell", NULL, &ignition_epochs_kernel},
+    {"evaluate_pedestrian_vision", "pedestrian", NULL, &pedestrian_vision_kernel},
+    {"insert_pedestrians_at_random", "cell", &remove_pedestrians, &pedestrian_insertion_kernel} // Replaces the pedestrians of the vision benchmark.
+};
+
+static const char *synthetic_environments[] = {"synthetic:64x64", "synthetic:128x128", "synthetic:256x256"};
+
+static Location *exit_cells = NULL; // Cells of every exit of the prepared environment, none of which is blocked.
+static int num_exit_cells = 0;
+static Field_Grid initial_dynamic_field = NULL;
+
+/**
+ * Benchmarks the environments given as arguments (file names within environments/, or "synthetic:LINESxCOLUMNS" for an empty
+ * room). Without arguments, every shipped environment and a few synthetic rooms are benchmarked.
+ */
+int main(int argc, char **argv)
+{
+    printf("environment,lines,columns,kernel,item,items,repetitions,ns_per_call,ns_per_item,items_per_second\n");
+    fflush(stdout);
+
+    if(argc > 1)
+    {
+        for(int arg_index = 1; arg_index < argc; arg_index++)
+            benchmark_environment(argv[arg_index]);
+
+        return 0;
+    }
+
+    DIR *environment_directory = opendir("environments/");
+    if(environment_directory == NULL)
+    {
+        fprintf(stderr, "It was not possible to open the environments directory.\n");
+        return 1;
+    }
+
+    struct dirent *entry = NULL;
+    while((entry = readdir(environment_directory)) != NULL)
+    {
+        size_t length = strlen(entry->d_name);
+        if(length > 4 && strcmp(entry->d_name + length - 4, ".txt") == 0)
+            benchmark_environment(entry->d_name);
+    }
+    closedir(environment_directory);
+
+    for(size_t index = 0; index < sizeof(synthetic_environments) / sizeof(synthetic_environments[0]); index++)
+        benchmark_environment(synthetic_environments[index]);
+
+    return 0;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Runs every kernel benchmark over an environment. Each environment is benchmarked in a child process, since the program
+ * structures are global and aren't meant to be reloaded.
+ *
+ * @param environment Name of the environment file, or "synthetic:LINESxCOLUMNS".
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status benchmark_environment(const char *environment)
+{
+    pid_t child = fork();
+    if(child < 0)
+    {
+        perror("Failure to fork the benchmark process");
+        return FAILURE;
+    }
+
+    if(child == 0)
+    {
+        if(prepare_environment(environment) == FAILURE)
+            _exit(1);
+
+        for(size_t index = 0; index < sizeof(kernel_benchmarks) / sizeof(kernel_benchmarks[0]); index++)
+            time_kernel(environment, &kernel_benchmarks[index]);
+
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int child_status = 0;
+    waitpid(child, &child_status, 0);
+    if(! WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+    {
+        fprintf(stderr, "The benchmark of %s failed.\n", environment);
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Loads (or generates) the environment and computes every field, as done before the first timestep of a simulation.
+ * Environments without exits receive one in the middle of the top wall, and environments without fire receive a fire cell in the middle.
+ *
+ * @param environment Name of the environment file, or "synthetic:LINESxCOLUMNS".
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status prepare_environment(const char *environment)
+{
+    int lines = 0, columns = 0;
+
+    cli_args.environment_origin = STRUCTURE_AND_DOORS;
+
+    if(sscanf(environment, "synthetic:%dx%d", &lines, &columns) == 2)
+    {
+        cli_args.global_line_number = lines;
+        cli_args.global_column_number = columns;
+        if(generate_environment() == FAILURE)
+            return FAILURE;
+    }
+    else
+    {
+        strcpy(cli_args.environment_filename, environment);
+        if(load_environment() == FAILURE)
+            return FAILURE;
+    }
+
+    if(exits_set.num_exits == 0 && add_synthetic_exit() == FAILURE)
+        return FAILURE;
+
+    if(! cli_args.fire_is_present)
+        add_synthetic_fire();
+
+    if(calculate_all_static_weights() != SUCCESS || allocate_exits_set_fields() == FAILURE || build_walkable_graph() == FAILURE)
+        return FAILURE;
+
+    initial_dynamic_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    if(initial_dynamic_field == NULL)
+        return FAILURE;
+
+    if(prepare_fields() == FAILURE)
+        return FAILURE;
+
+    srand(0);
+    if(insert_pedestrians_at_random((int) (count_number_empty_cells() * BENCHMARK_DENSITY)) == FAILURE)
+        return FAILURE;
+
+    return SUCCESS;
+}
+
+/**
+ * Adds a single-cell exit to the top wall, at the column closest to the middle whose cell below is empty.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status add_synthetic_exit()
+{
+    int middle = cli_args.global_column_number / 2;
+
+    for(int offset = 0; offset < middle; offset++)
+    {
+        for(int column = middle - offset; column <= middle + offset; column += offset > 0 ? 2 * offset : 1)
+        {
+            if(column <= 0 || column >= cli_args.global_column_number - 1 || obstacle_grid[1][column] != EMPTY_CELL)
+                continue;
+
+            Location exit_cell = {0, column};
+            if(add_new_exit(exit_cell) == FAILURE)
+                return FAILURE;
+
+            cell_state_grid[exit_cell.lin][exit_cell.col] |= EXIT_STATE;
+
+            return set_private_grid_data(exits_set.list[0]);
+        }
+    }
+
+    fprintf(stderr, "The top wall of the environment has no cell where an exit could be placed.\n");
+    return FAILURE;
+}
+
+/**
+ * Sets the empty cell closest to the middle of the environment (searching along its line) on fire.
+ */
+static void add_synthetic_fire()
+{
+    int line = cli_args.global_line_number / 2;
+
+    for(int column = cli_args.global_column_number / 2; column < cli_args.global_column_number; column++)
+    {
+        if(obstacle_grid[line][column] == EMPTY_CELL)
+        {
+            initial_fire_grid[line][column] = FIRE_CELL;
+            cli_args.fire_is_present = true;
+            return;
+        }
+    }
+}
+
+/**
+ * Computes the fire and static fields, as prepare_simulation_set does, lists the exit cells and fills the dynamic field with
+ * particles, so every kernel works on realistic data.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status prepare_fields()
+{
+    calculate_ignition_epochs();
+    current_fire_epoch = 0;
+    mark_fire_cells();
+    calculate_fire_floor_field();
+    determine_risky_cells();
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+        calculate_exit_distance_grid(exits_set.list[exit_index]);
+
+    compose_zheng_static_field(NULL);
+    compose_distance_to_closest_exit();
+
+    num_exit_cells = 0;
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+        num_exit_cells += exits_set.list[exit_index]->width;
+
+    exit_cells = malloc(sizeof(Location) * num_exit_cells);
+    if(exit_cells == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of exit cells.\n");
+        return FAILURE;
+    }
+
+    for(int exit_index = 0, cell_count = 0; exit_index < exits_set.num_exits; exit_index++)
+    {
+        for(int cell_index = 0; cell_index < exits_set.list[exit_index]->width; cell_index++, cell_count++)
+            exit_cells[cell_count] = exits_set.list[exit_index]->coordinates[cell_index];
+    }
+
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+            initial_dynamic_field[i][j] = obstacle_grid[i][j] == EMPTY_CELL ? (i * 7 + j * 3) % 5 : 0;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Times a kernel, repeating it until MIN_BENCHMARK_TIME seconds (and at least MIN_REPETITIONS calls) were spent in it, and prints a CSV line with the results.
+ *
+ * @param environment Name of the environment, printed in the CSV line.
+ * @param benchmark The kernel to be timed.
+ */
+static void time_kernel(const char *environment, Kernel_Benchmark *benchmark)
+{
+    double total_nanoseconds = 0;
+    int repetitions = 0;
+    long items = strcmp(benchmark->item, "pedestrian") == 0 ? number_vision_pedestrians() :
+                 (long) cli_args.global_line_number * cli_args.global_column_number;
+
+    while(repetitions < MIN_REPETITIONS || total_nanoseconds < MIN_BENCHMARK_TIME * 1E9)
+    {
+        struct timespec start, end;
+
+        if(benchmark->setup != NULL)
+            benchmark->setup();
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        benchmark->kernel();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        total_nanoseconds += elapsed_nanoseconds(start, end);
+        repetitions++;
+    }
+
+    double ns_per_call = total_nanoseconds / repetitions;
+    double ns_per_item = items > 0 ? ns_per_call / items : 0;
+
+    printf("%s,%d,%d,%s,%s,%ld,%d,%.1f,%.3f,%.0f\n", environment, cli_args.global_line_number, cli_args.global_column_number,
+           benchmark->name, benchmark->item, items, repetitions, ns_per_call, ns_per_item, ns_per_item > 0 ? 1E9 / ns_per_item : 0);
+}
+
+/**
+ * Returns the time between two instants, in nanoseconds.
+ */
+static double elapsed_nanoseconds(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1E9 + (end.tv_nsec - start.tv_nsec);
+}
+
+/**
+ * Returns the number of pedestrians whose vision is evaluated by the vision benchmark.
+ */
+static int number_vision_pedestrians()
+{
+    return pedestrian_set.num_pedestrians < MAX_VISION_PEDESTRIANS ? pedestrian_set.num_pedestrians : MAX_VISION_PEDESTRIANS;
+}
+
+static void static_field_kernel()
+{
+    calculate_zheng_static_field(exit_cells, num_exit_cells, exits_set.aux_static_grid); // As evaluate_pedestrian_vision does.
+}
+
+static void composed_static_field_kernel()
+{
+    compose_zheng_static_field(NULL);
+}
+
+static void restore_composed_static_field()
+{
+    current_fire_epoch = 0;
+    compose_zheng_static_field(NULL);
+}
+
+static void ignited_cells_removal_kernel()
+{
+    current_fire_epoch = 1; // The first spread of the fire.
+    remove_ignited_cells_from_zheng_static_field(NULL);
+    current_fire_epoch = 0;
+}
+
+static void static_weight_kernel()
+{
+    calculate_static_weight(exits_set.list[0]);
+}
+
+static void fire_distance_kernel()
+{
+    calculate_distance_from_cells_to_fire();
+}
+
+static void restore_dynamic_field()
+{
+    copy_field_grid(exits_set.dynamic_floor_field, initial_dynamic_field);
+}
+
+static void decay_and_diffusion_kernel()
+{
+    apply_decay_and_diffusion();
+}
+
+static void ignition_epochs_kernel()
+{
+    calculate_ignition_epochs();
+}
+
+static void pedestrian_vision_kernel()
+{
+    for(int p_index = 0; p_index < number_vision_pedestrians(); p_index++)
+        evaluate_pedestrian_vision(pedestrian_set.list[p_index]);
+}
+
+static void remove_pedestrians()
+{
+    deallocate_pedestrians();
+}
+
+static void pedestrian_insertion_kernel()
+{
+    insert_pedestrians_at_random((int) (count_number_empty_cells() * INSERTION_DENSITY));
+}
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""
+   File: macro_benchmark.py
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: End-to-end benchmark of the program. Each shipped environment is evacuated, with fixed seeds, using its matching
+                auxiliary file, and the wall time, timesteps per second, pedestrian-steps per second and peak RSS of every scenario
+                are stored in a JSON baseline. Two baselines can then be compared to find performance regressions.
+
+   Usage:
+       python3 bench/macro_benchmark.py run [--output FILE] [--repetitions N] [--workers N] [--executable EXE] [SCENARIO...]
+       python3 bench/macro_benchmark.py compare BASELINE CURRENT [--tolerance FRACTION]
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# Each scenario is an environment, the load method used and, for the load methods without static exits, its auxiliary file,
+# of which only the first "sets" simulation sets are run. The number of sets and simulations keeps every scenario within a few
+# seconds, since some exit placements of the auxiliary files take thousands of timesteps to evacuate.
+SCENARIOS = [
+    {"name": "varas_classroom_with_obstacles", "environment": "varas_classroom_with_obstacles.txt",
+     "auxiliary": "varas_optimal_location.txt", "sets": 4, "method": 3, "simulations": 1},
+    {"name": "varas_classroom_without_obstacles", "environment": "varas_classroom_without_obstacles.txt",
+     "auxiliary": "varas_optimal_location.txt", "sets": 4, "method": 3, "simulations": 1},
+    {"name": "varas_classroom_2_with_obstacles", "environment": "varas_classroom_2_with_obstacles.txt",
+     "auxiliary": "varas_optimal_location_2.txt", "sets": 4, "method": 3, "simulations": 1},
+    {"name": "varas_classroom_2_without_obstacles", "environment": "varas_classroom_2_without_obstacles.txt",
+     "auxiliary": "varas_door_width.txt", "sets": 4, "method": 3, "simulations": 1},
+    {"name": "varas_queue", "environment": "varas_queue.txt",
+     "auxiliary": "varas_section_3.txt", "sets": 1, "method": 3, "simulations": 10},
+    {"name": "alizadeh_classroom", "environment": "alizadeh_classroom.txt",
+     "auxiliary": None, "sets": 1, "method": 4, "simulations": 5},
+    {"name": "alizadeh_crowd", "environment": "alizadeh_crowd.txt",
+     "auxiliary": "alizadeh_doorWidth_simulationSet.txt", "sets": 2, "method": 3, "simulations": 1},
+    {"name": "alizadeh_restaurant_1", "environment": "alizadeh_restaurant_1.txt",
+     "auxiliary": None, "sets": 1, "method": 4, "simulations": 3},
+    {"name": "alizadeh_restaurant_2", "environment": "alizadeh_restaurant_2.txt",
+     "auxiliary": None, "sets": 1, "method": 4, "simulations": 3},
+    {"name": "zheng_four_exits_fire_left", "environment": "zheng_four_exits_fire_left.txt",
+     "auxiliary": None, "sets": 1, "method": 2, "simulations": 2},
+]
+
+BASELINE_FORMAT = 1
+STATISTICS_PATTERN = re.compile(r"simulations (\d+) timesteps (\d+) pedestrian_steps (\d+)")
+
+
+def scenario_arguments(scenario, workers):
+    """Returns the command line arguments of a scenario. The seed is fixed, so every run evacuates the same pedestrians."""
+    arguments = ["-e", scenario["environment"], "-m", str(scenario["method"]), "-O", "2",
+                 "-s", str(scenario["simulations"]), "--seed=0", "--workers=%d" % workers, "--run-statistics"]
+
+    if scenario["auxiliary"] is not None:
+        arguments += ["-a", scenario["auxiliary"]]
+
+    return arguments
+
+
+def prepare_working_directory(directory, scenario):
+    """
+    Prepares the directory where the program runs: environments/ links to the shipped environments, and auxiliary/ holds the
+    first simulation sets of the scenario's auxiliary file.
+    """
+    repository = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    os.symlink(os.path.join(repository, "environments"), os.path.join(directory, "environments"))
+    os.mkdir(os.path.join(directory, "auxiliary"))
+
+    if scenario["auxiliary"] is not None:
+        with open(os.path.join(repository, "auxiliary", scenario["auxiliary"])) as auxiliary_file:
+            simulation_sets = [line for line in auxiliary_file if line.strip() != ""][:scenario["sets"]]
+
+        with open(os.path.join(directory, "auxiliary", scenario["auxiliary"]), "w") as auxiliary_file:
+            auxiliary_file.writelines(simulation_sets)
+
+
+def run_scenario(executable, arguments, directory):
+    """Runs the program once. Returns its wall time, in seconds, the statistics it printed and its peak RSS, in KiB."""
+    start = time.perf_counter()
+    process = subprocess.Popen([executable] + arguments, cwd=directory, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    error_output = process.stderr.read()
+    _, exit_status, usage = os.wait4(process.pid, 0)
+    wall_seconds = time.perf_counter() - start
+    process.returncode = os.waitstatus_to_exitcode(exit_status)
+
+    match = STATISTICS_PATTERN.search(error_output)
+    if process.returncode != 0 or match is None:
+        raise RuntimeError("%s %s failed:\n%s" % (executable, " ".join(arguments), error_output))
+
+    statistics = {"simulations": int(match.group(1)), "timesteps": int(match.group(2)), "pedestrian_steps": int(match.group(3))}
+
+    return wall_seconds, statistics, usage.ru_maxrss
+
+
+def run_benchmark(options):
+    """Runs the selected scenarios and writes the baseline. The fastest repetition of each scenario is the one recorded."""
+    selected = [scenario for scenario in SCENARIOS if not options.scenarios or scenario["name"] in options.scenarios]
+    unknown = set(options.scenarios) - {scenario["name"] for scenario in SCENARIOS}
+    if unknown:
+        sys.exit("Unknown scenarios: %s" % ", ".join(sorted(unknown)))
+
+    baseline = {
+        "format": BASELINE_FORMAT,
+        "date": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+        "host": platform.node(),
+        "executable": options.executable,
+        "repetitions": options.repetitions,
+        "workers": options.workers,
+        "scenarios": {},
+    }
+
+    print("%-36s %10s %12s %16s %12s" % ("scenario", "wall (s)", "timesteps/s", "ped-steps/s", "peak RSS (KiB)"))
+    for scenario in selected:
+        arguments = scenario_arguments(scenario, options.workers)
+        wall_times = []
+        peak_rss = 0
+        statistics = None
+
+        with tempfile.TemporaryDirectory() as directory:
+            prepare_working_directory(directory, scenario)
+
+            for _ in range(options.repetitions):
+                wall_seconds, statistics, rss = run_scenario(os.path.abspath(options.executable), arguments, directory)
+                wall_times.append(wall_seconds)
+                peak_rss = max(peak_rss, rss)
+
+        wall_seconds = min(wall_times)
+        result = dict(statistics)
+        result.update({
+            "arguments": arguments,
+            "simulation_sets": scenario["sets"],
+            "wall_seconds": wall_seconds,
+            "all_wall_seconds": wall_times,
+            "timesteps_per_second": statistics["timesteps"] / wall_seconds,
+            "pedestrian_steps_per_second": statistics["pedestrian_steps"] / wall_seconds,
+            "peak_rss_kib": peak_rss,
+        })
+        baseline["scenarios"][scenario["name"]] = result
+
+        print("%-36s %10.3f %12.0f %16.0f %12d" % (scenario["name"], wall_seconds, result["timesteps_per_second"],
+                                                    result["pedestrian_steps_per_second"], peak_rss))
+
+    with open(options.output, "w") as baseline_file:
+        json.dump(baseline, baseline_file, indent=2)
+        baseline_file.write("\n")
+
+    print("Baseline written to %s." % options.output)
+
+
+def compare_baselines(options):
+    """Compares two baselines. Exits with status 1 if the pedestrian-steps per second of a scenario dropped beyond the tolerance."""
+    with open(options.baseline) as baseline_file, open(options.current) as current_file:
+        baseline = json.load(baseline_file)
+        current = json.load(current_file)
+
+    regressions = 0
+    print("%-36s %10s %10s %9s %11s %9s  %s" % ("scenario", "base (s)", "curr (s)", "wall", "ped-steps/s", "RSS", "status"))
+    for name, base in baseline["scenarios"].items():
+        if name not in current["scenarios"]:
+            print("%-36s %s" % (name, "missing from the current run"))
+            continue
+
+        curr = current["scenarios"][name]
+        wall_change = curr["wall_seconds"] / base["wall_seconds"] - 1
+        throughput_change = curr["pedestrian_steps_per_second"] / base["pedestrian_steps_per_second"] - 1
+        rss_change = curr["peak_rss_kib"] / base["peak_rss_kib"] - 1
+
+        # The throughput is compared, instead of the wall time, so changes that alter the random streams (and therefore the
+        # number of timesteps run) are still measured fairly. Such changes are reported, since they alter the results.
+        status = "ok"
+        if curr["arguments"] != base["arguments"]:
+            status = "different arguments"
+        elif throughput_change < -options.tolerance:
+            status = "SLOWER"
+            regressions += 1
+        elif throughput_change > options.tolerance:
+            status = "faster"
+
+        if curr["timesteps"] != base["timesteps"] or curr["pedestrian_steps"] != base["pedestrian_steps"]:
+            status += ", different results"
+
+        print("%-36s %10.3f %10.3f %+8.1f%% %+10.1f%% %+8.1f%%  %s" % (name, base["wall_seconds"], curr["wall_seconds"],
+                                                                       100 * wall_change, 100 * throughput_change, 100 * rss_change, status))
+
+    sys.exit(1 if regressions > 0 else 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="End-to-end benchmark of the shipped scenarios.")
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = subparsers.add_parser("run", help="Runs the scenarios and writes a JSON baseline.")
+    run_parser.add_argument("scenarios", nargs="*", help="Scenarios to be run (all of them by default).")
+    run_parser.add_argument("--output", default="bench/macro_baseline.json", help="Where the baseline is written.")
+    run_parser.add_argument("--repetitions", type=int, default=3, help="Runs of each scenario. The fastest is recorded.")
+    run_parser.add_argument("--workers", type=int, default=1, help="Value of the --workers option of the program.")
+    run_parser.add_argument("--executable", default="build/release/zheng.exe", help="The program to be benchmarked.")
+
+    compare_parser = subparsers.add_parser("compare", help="Compares a run against a baseline.")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("current")
+    compare_parser.add_argument("--tolerance", type=float, default=0.05,
+                                help="Relative drop of the pedestrian-steps per second above which a scenario is reported as slower.")
+
+    options = parser.parse_args()
+    if options.command == "run":
+        run_benchmark(options)
+    else:
+        compare_baselines(options)
+
+
+if __name__ == "__main__":
+    main()
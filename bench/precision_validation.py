@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+   File: precision_validation.py
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: Validation of the single-precision fields (make FIELDS=float). The scenarios of the macro-benchmark are evacuated
+                by a program built with double fields and by one built with float fields, with the same seeds, and the
+                distributions of their evacuation times are compared: the mean and standard deviation of each one, the fraction
+                of simulations that evacuated in the same number of timesteps and a two-sample Kolmogorov-Smirnov test. A
+                scenario fails when the test rejects, at the given significance, that both programs draw the same distribution.
+
+   Usage:
+       python3 bench/precision_validation.py [--double EXE] [--float EXE] [--simulations N] [--workers N] [--significance P] [SCENARIO...]
+"""
+
+import argparse
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+from macro_benchmark import SCENARIOS, prepare_working_directory
+
+
+def scenario_arguments(scenario, simulations, workers):
+    """Returns the command line arguments of a scenario, with the evacuation times written to the standard output."""
+    arguments = ["-e", scenario["environment"], "-m", str(scenario["method"]), "-O", "2",
+                 "-s", str(simulations), "--seed=0", "--workers=%d" % workers]
+
+    if scenario["auxiliary"] is not None:
+        arguments += ["-a", scenario["auxiliary"]]
+
+    return arguments
+
+
+def run_evacuation_times(executable, arguments, directory):
+    """Runs the program once. Returns the evacuation times it printed, simulation set after simulation set."""
+    process = subprocess.run([executable] + arguments, cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+    if process.returncode != 0:
+        raise RuntimeError("%s %s failed:\n%s" % (executable, " ".join(arguments), process.stderr))
+
+    evacuation_times = []
+    for line in process.stdout.splitlines():
+        fields = line.split()
+        if fields and all(field.lstrip("-").isdigit() for field in fields):
+            evacuation_times += [int(field) for field in fields]
+
+    return evacuation_times
+
+
+def mean_and_deviation(values):
+    """Returns the mean and the sample standard deviation of the values."""
+    mean = sum(values) / len(values)
+    if len(values) < 2:
+        return mean, 0.0
+
+    return mean, math.sqrt(sum((value - mean) ** 2 for value in values) / (len(values) - 1))
+
+
+def kolmogorov_smirnov(first, second):
+    """Returns the two-sample Kolmogorov-Smirnov statistic of the samples and its asymptotic p-value."""
+    first, second = sorted(first), sorted(second)
+    i = j = 0
+    statistic = 0.0
+
+    while i < len(first) and j < len(second):
+        value = min(first[i], second[j])
+        while i < len(first) and first[i] == value:
+            i += 1
+        while j < len(second) and second[j] == value:
+            j += 1
+        statistic = max(statistic, abs(i / len(first) - j / len(second)))
+
+    effective_size = len(first) * len(second) / (len(first) + len(second))
+    lambda_value = (math.sqrt(effective_size) + 0.12 + 0.11 / math.sqrt(effective_size)) * statistic
+    if lambda_value < 1e-3:
+        return statistic, 1.0
+
+    p_value = 2 * sum((-1) ** (k - 1) * math.exp(-2 * k * k * lambda_value * lambda_value) for k in range(1, 101))
+
+    return statistic, min(max(p_value, 0.0), 1.0)
+
+
+def validate(options):
+    """Compares the evacuation times of both programs on the selected scenarios. Exits with status 1 if any scenario fails."""
+    selected = [scenario for scenario in SCENARIOS if not options.scenarios or scenario["name"] in options.scenarios]
+    unknown = set(options.scenarios) - {scenario["name"] for scenario in SCENARIOS}
+    if unknown:
+        sys.exit("Unknown scenarios: %s" % ", ".join(sorted(unknown)))
+
+    failures = 0
+    print("%-36s %6s %18s %18s %9s %7s %8s  %s" % ("scenario", "runs", "double mean (sd)", "float mean (sd)", "identical", "KS D", "p-value", "status"))
+    for scenario in selected:
+        arguments = scenario_arguments(scenario, options.simulations, options.workers)
+
+        with tempfile.TemporaryDirectory() as directory:
+            prepare_working_directory(directory, scenario)
+            double_times = run_evacuation_times(os.path.abspath(options.double), arguments, directory)
+            float_times = run_evacuation_times(os.path.abspath(options.float), arguments, directory)
+
+        if len(double_times) != len(float_times) or not double_times:
+            print("%-36s %s" % (scenario["name"], "different number of simulations (%d and %d)" % (len(double_times), len(float_times))))
+            failures += 1
+            continue
+
+        # Inaccessible simulation sets are printed with negative times, which only take part in the paired comparison.
+        double_evacuated = [time for time in double_times if time >= 0]
+        float_evacuated = [time for time in float_times if time >= 0]
+        identical = sum(first == second for first, second in zip(double_times, float_times)) / len(double_times)
+
+        if not double_evacuated or not float_evacuated:
+            status = "ok" if identical == 1 else "FAILED"
+            failures += status != "ok"
+            print("%-36s %6d %18s %18s %8.1f%% %7s %8s  %s" % (scenario["name"], len(double_times), "-", "-", 100 * identical, "-", "-", status))
+            continue
+
+        double_mean, double_deviation = mean_and_deviation(double_evacuated)
+        float_mean, float_deviation = mean_and_deviation(float_evacuated)
+        statistic, p_value = kolmogorov_smirnov(double_evacuated, float_evacuated)
+
+        status = "ok"
+        if p_value < options.significance:
+            status = "FAILED"
+            failures += 1
+
+        print("%-36s %6d %10.1f (%5.1f) %10.1f (%5.1f) %8.1f%% %7.3f %8.3f  %s" % (scenario["name"], len(double_times), double_mean, double_deviation,
+                                                                                 float_mean, float_deviation, 100 * identical, statistic, p_value, status))
+
+    sys.exit(1 if failures > 0 else 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compares the evacuation times of the programs built with double and float fields.")
+    parser.add_argument("scenarios", nargs="*", help="Scenarios to be run (all of them by default).")
+    parser.add_argument("--double", default="build/release/zheng.exe", help="The program built with double fields.")
+    parser.add_argument("--float", default="build/release-float/zheng.exe", help="The program built with float fields (make FIELDS=float).")
+    parser.add_argument("--simulations", type=int, default=30, help="Simulations of each simulation set, with consecutive seeds.")
+    parser.add_argument("--workers", type=int, default=os.cpu_count(), help="Value of the --workers option of the programs.")
+    parser.add_argument("--significance", type=float, default=0.01,
+                        help="Significance level of the Kolmogorov-Smirnov test below which a scenario fails.")
+
+    validate(parser.parse_args())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,19 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include<stdbool.h>
+#include<stdint.h>
+
+#include"shared_resources.h"
+
+#define BITS_PER_WORD 64
+#define BITBOARD_WORDS(column_number) (((column_number) + BITS_PER_WORD - 1) / BITS_PER_WORD) // Words of each line of a bitboard.
+
+typedef uint64_t ** Bitboard; // One bit per cell: bit (column % 64) of the word (column / 64) of the line.
+
+Bitboard allocate_bitboard(int line_number, int column_number);
+void set_bitboard_cell(Bitboard bitboard, Location cell);
+bool dilate_bitboard(Bitboard destination, Bitboard source, Bitboard mask, int *first_line, int *last_line);
+int extract_bitboard_cells(Bitboard bitboard, int first_line, int last_line, Location *cells);
+
+#endif
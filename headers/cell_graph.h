@@ -0,0 +1,24 @@
+#ifndef CELL_GRAPH_H
+#define CELL_GRAPH_H
+
+#include"shared_resources.h"
+#include"grid.h"
+
+#define NO_NEIGHBOR -1 // Index of a neighbor outside the walkable graph (a wall, an obstacle or outside the environment).
+
+typedef struct{
+    int num_cells;
+    Location *cells; // Cells of the graph, line after line.
+    int *offsets; // Position of each cell in the contiguous block of the grids (line * number of columns + column).
+    int *von_neumann_neighbors; // Four per cell, in the order of non_diagonal_modifiers: the index of the neighbor in the graph, or NO_NEIGHBOR.
+    Int_Grid index_grid; // Index of each cell in the graph, or NO_NEIGHBOR for the cells outside it.
+    int num_insertion_cells;
+    int *insertion_cells; // Indices of the cells where pedestrians may be inserted at random: those that aren't exits nor in the first and last lines and columns.
+}Cell_Graph;
+
+Function_Status build_walkable_graph();
+void deallocate_walkable_graph();
+
+extern Cell_Graph walkable_graph;
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include<stdbool.h>
+
+#include"shared_resources.h"
+
+typedef struct simulation_state * Simulation_State;
+
+void initialize_random_state();
+Simulation_State capture_simulation_state(int timesteps, bool has_the_fire_spread);
+Function_Status restore_simulation_state(Simulation_State state, int *timesteps, bool *has_the_fire_spread);
+bool is_state_compatible(Simulation_State state);
+Function_Status write_simulation_state(Simulation_State state, const char *filename);
+Simulation_State read_simulation_state(const char *filename);
+void deallocate_simulation_state(Simulation_State state);
+
+#endif
@@ -11,15 +11,23 @@ typedef struct{
     char environment_filename[150];
     char output_filename[150];
     char auxiliary_filename[150];
+    char sweep_filename[150];
+    char save_checkpoint_filename[150];
+    char load_checkpoint_filename[150];
+    char profile_filename[150];
     enum Output_Format output_format;
     enum Environment_Origin environment_origin;
     enum Simulation_Type simulation_type;
+    enum Combination_Rule combination_rule;
     bool write_to_file;
     bool show_debug_information;
     bool show_simulation_set_info;
     bool immediate_exit;
     bool prevent_corner_crossing;
     bool single_exit_flag;
+    bool print_run_statistics; // Prints the number of simulations, timesteps and pedestrian-steps run, at the end of the program.
+    bool profile; // Times each phase of the timestep loop, printing a summary per simulation set.
+    bool use_weight_cache; // Reads and stores the static weights of the exits in the cache directory.
     bool use_density; // Indicates if the number os pedestrians to be inserted (if the case) is to be based on the density or in the total_num_pedestrians.
     bool fire_is_present;
     int global_line_number;
@@ -27,6 +35,11 @@ typedef struct{
     int num_simulations;
     int total_num_pedestrians;
     int seed;
+    int num_workers; // Number of worker processes among which the simulations of a simulation set are divided.
+    int heatmap_window; // Number of timesteps in each heatmap window. If 0, a single heatmap for the whole simulations is produced.
+    int min_simulations; // Minimum number of simulations per point before the convergence test is applied.
+    int checkpoint_timestep; // Timestep at the end of which the checkpoint given by save_checkpoint_filename is captured.
+    int door_combination_size; // Number of candidate doors in each simulation set of the door-combination mode. If 0, the mode is disabled.
     double diagonal;
     double alpha;
     double fire_alpha;
@@ -43,6 +56,7 @@ typedef struct{
     double max;
     double step;
     double spread_rate;
+    double convergence_tolerance; // Relative half-width of the confidence interval that ends a point's simulations. If 0, all simulations are run.
 } Command_Line_Args;
 
 error_t parser_function(int key, char *arg, struct argp_state *state);
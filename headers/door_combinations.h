@@ -0,0 +1,17 @@
+#ifndef DOOR_COMBINATIONS_H
+#define DOOR_COMBINATIONS_H
+
+#include<stdio.h>
+
+#include"shared_resources.h"
+
+Function_Status load_candidate_doors(FILE *auxiliary_file);
+int count_door_combinations();
+Function_Status get_next_door_combination(int *exit_number);
+Function_Status get_door_combination(int combination_index, int *exit_number);
+Function_Status check_door_combination_accessibility();
+void release_door_combination();
+void detach_door_combination();
+void deallocate_door_combinations();
+
+#endif
@@ -1,12 +1,24 @@
 #ifndef FIRE_DYNAMICS_H
 #define FIRE_DYNAMICS_H
 
+#include<limits.h>
+
 #include"shared_resources.h"
 #include"grid.h"
 
-void zheng_fire_propagation();
+#define NEVER_IGNITED INT_MAX // Ignition epoch of the cells that the fire never reaches.
+
+Function_Status calculate_ignition_epochs();
+const Location *find_ignited_cells(int epoch, int *num_cells);
+void mark_fire_cells();
+void mark_ignited_cells();
+void deallocate_ignition_order();
+void write_fire_cells(int *fire_cells);
+int find_fire_epoch(const int *fire_cells);
 
-extern Int_Grid fire_grid;
 extern Int_Grid initial_fire_grid;
+extern Int_Grid ignition_epoch_grid;
+extern int last_ignition_epoch;
+extern int current_fire_epoch;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef FIRE_TIMELINE_H
+#define FIRE_TIMELINE_H
+
+#include"shared_resources.h"
+
+Function_Status prepare_fire_timeline();
+void restore_initial_fire_epoch();
+Function_Status spread_fire(bool *has_the_fire_spread);
+Function_Status update_fields_after_fire_spread();
+void deallocate_fire_timeline();
+
+#endif
@@ -2,22 +2,50 @@
 #define GRID_H
 
 #include<stdbool.h>
+#include<stddef.h>
+#include<stdint.h>
 
 #include"shared_resources.h"
 
+// Scalar of the floor fields and of the other real-valued grids (static weights and distances), chosen at compile time:
+// float when FLOAT_FIELDS is defined (make FIELDS=float), halving the memory traffic of the field kernels, or double otherwise.
+// Sums over the grids are still accumulated in double.
+#ifdef FLOAT_FIELDS
+typedef float Field_Value;
+#else
+typedef double Field_Value;
+#endif
+
 typedef int ** Int_Grid;
-typedef double ** Double_Grid;
+typedef Field_Value ** Field_Grid;
+typedef uint8_t ** Cell_State_Grid;
+
+// Flags of the cell_state_grid, combined in each cell.
+#define WALL_STATE 0x01 // A wall or an obstacle, i.e., an IMPASSABLE_OBJECT in the obstacle_grid (which includes the exits).
+#define EXIT_STATE 0x02 // An exit cell.
+#define BLOCKED_EXIT_STATE 0x04 // An exit cell of an exit blocked by fire.
+#define FIRE_STATE 0x08 // A cell with fire in the current fire epoch.
+#define RISKY_STATE 0x10 // A cell close to the fire, but the pedestrians seem it as a calculated risky.
+#define DANGER_STATE 0x20 // A cell too close to the fire. The pedestrians will avoid these cells altogether.
+#define OCCUPIED_STATE 0x40 // A cell occupied by a pedestrian.
+
+#define ANY_EXIT_STATE (EXIT_STATE | BLOCKED_EXIT_STATE)
+#define FIRE_EPOCH_STATES (FIRE_STATE | RISKY_STATE | DANGER_STATE) // The flags that change when the fire spreads.
 
 Int_Grid allocate_integer_grid(int line_number, int column_number);
-Double_Grid allocate_double_grid(int line_number, int column_number);
+Field_Grid allocate_field_grid(int line_number, int column_number);
+Cell_State_Grid allocate_cell_state_grid(int line_number, int column_number);
 Function_Status fill_integer_grid(Int_Grid integer_grid, int line_number, int column_number, int value);
-Function_Status fill_double_grid(Double_Grid double_grid, int line_number, int column_number, double value);
+Function_Status fill_field_grid(Field_Grid field_grid, int line_number, int column_number, double value);
 Function_Status copy_integer_grid(Int_Grid destination, Int_Grid source);
-Function_Status copy_double_grid(Double_Grid destination, Double_Grid source);
+Function_Status copy_field_grid(Field_Grid destination, Field_Grid source);
+void copy_cell_state_flags(Cell_State_Grid destination, Cell_State_Grid source, uint8_t flags);
+void clear_cell_state_flags(Cell_State_Grid cell_state, uint8_t flags);
 Function_Status copy_non_empty_cells(Int_Grid destination, Int_Grid source);
-Function_Status replace_non_empty_cells(Double_Grid destination, Int_Grid source, double value);
+Function_Status replace_non_empty_cells(Field_Grid destination, Int_Grid source, double value);
 Function_Status sum_grids(Int_Grid destination, Int_Grid source);
-bool is_diagonal_valid(Location origin_cell, Location target_cell, Double_Grid floor_field);
+void sum_integer_blocks(int *restrict destination, const int *restrict source, size_t length);
+bool is_diagonal_valid(Location origin_cell, Location target_cell, Field_Grid floor_field);
 bool is_within_grid_lines(int line_coordinate);
 bool is_within_grid_columns(int column_coordinate);
 bool is_cell_empty(Location coordinates);
@@ -25,7 +53,6 @@ bool is_cell_with_fire(Location coordinates);
 void deallocate_grid(void **grid, int line_number);
 
 extern Int_Grid obstacle_grid;
-extern Int_Grid heatmap_grid;
-extern Int_Grid risky_cells_grid;
+extern Cell_State_Grid cell_state_grid;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include"shared_resources.h"
+#include"grid.h"
+
+Function_Status close_heatmap_window(int window_index);
+void clear_heatmap_data();
+Function_Status write_heatmap_data(int file_descriptor);
+Function_Status read_and_reduce_heatmap_data(int file_descriptor);
+void deallocate_heatmap_windows();
+
+extern Int_Grid heatmap_grid;
+extern Int_Grid *heatmap_windows;
+extern int num_heatmap_windows;
+
+#endif
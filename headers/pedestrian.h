@@ -23,11 +23,13 @@ typedef struct{
     Pedestrian *list;
     int num_pedestrians;
     int num_dead_pedestrians;
+    int list_capacity; // Number of pedestrians the list has room for. Grows geometrically, so inserting many pedestrians takes linear time.
 } Pedestrian_Set;
 
 Function_Status insert_pedestrians_at_random(int qtd);
 Function_Status add_new_pedestrian(Location pedestrian_coordinates);
 void deallocate_pedestrians();
+void select_movement_kernels();
 void evaluate_pedestrians_movements();
 Function_Status identify_pedestrian_conflicts(Cell_Conflict *pedestrian_conflicts, int *num_conflicts);
 Function_Status solve_pedestrian_conflicts(Cell_Conflict pedestrian_conflicts, int num_conflicts);
@@ -35,8 +37,10 @@ void print_pedestrian_conflict_information(Cell_Conflict pedestrian_conflicts, i
 void apply_pedestrian_movement();
 void update_pedestrian_position_grid();
 bool is_environment_empty();
+int count_pedestrians_in_environment();
 void reset_pedestrian_state();
 void reset_pedestrians_structures();
+bool evaluate_pedestrian_vision(Pedestrian current_pedestrian);
 
 extern Int_Grid pedestrian_position_grid;
 extern Pedestrian_Set pedestrian_set;
@@ -0,0 +1,25 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include"shared_resources.h"
+
+typedef enum{
+    PHASE_VISION = 0,
+    PHASE_TRANSITION_PROBABILITIES,
+    PHASE_CONFLICTS,
+    PHASE_MOVEMENT,
+    PHASE_GRID_UPDATE,
+    PHASE_DIFFUSION,
+    PHASE_FIRE_PROPAGATION,
+    PHASE_STATIC_FIELD,
+    NUM_PROFILE_PHASES
+}Profile_Phase;
+
+Function_Status allocate_profile_counters();
+long long start_profile_phase();
+void end_profile_phase(Profile_Phase phase, long long start);
+void flush_profile_counters();
+Function_Status report_simulation_set_profile(int simulation_set_index);
+void deallocate_profile_counters();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef SET_SCHEDULER_H
+#define SET_SCHEDULER_H
+
+#include<stdio.h>
+#include<stdbool.h>
+
+#include"shared_resources.h"
+
+bool is_set_scheduling_enabled();
+Function_Status run_all_simulation_sets(FILE *output_file, FILE *auxiliary_file, int simulation_set_quantity);
+
+#endif
@@ -19,6 +19,12 @@ enum Output_Format {
     OUTPUT_HEATMAP,
 };
 
+enum Combination_Rule {
+    COMBINATION_UNORDERED = 1, // Distinct doors, in any order (each set of doors appears once).
+    COMBINATION_ORDERED, // Distinct doors, in every order.
+    COMBINATION_PRODUCT // Any doors, in every order (a door combined with itself gives a single-exit simulation set).
+};
+
 enum Environment_Origin {
     ONLY_STRUCTURE = 1, 
     STRUCTURE_AND_DOORS, 
@@ -39,11 +45,21 @@ typedef struct{
     int col;
 }Location;
 
+typedef struct{
+    int count;
+    double mean;
+    double sum_squared_deviations; // Sum of the squared deviations from the mean (M2 in Welford's algorithm).
+}Running_Statistics;
+
 #define TOLERANCE 1E-10
 
 #define CELL_LENGTH 0.4
 #define TIMESTEP_TIME (4.0 / 15)
 
+// Valid range of the fire spread rate: slower rates would never spread the fire, and faster ones would spread it more than once per timestep.
+#define MIN_SPREAD_RATE TOLERANCE
+#define MAX_SPREAD_RATE (CELL_LENGTH / TIMESTEP_TIME)
+
 #define IMPASSABLE_OBJECT -1000
 #define EXIT_CELL -1001
 #define BLOCKED_EXIT_CELL -1004
@@ -58,5 +74,7 @@ double euclidean_distance(Location first, Location second);
 float rand_within_limits(float min, float max);
 bool probability_test(double probability);
 int roulette_wheel_selection(double *probability_list, int length, double total_probability);
+void update_running_statistics(Running_Statistics *statistics, double sample);
+double calculate_confidence_half_width(Running_Statistics *statistics);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include<stdio.h>
+
+#include"shared_resources.h"
+
+typedef struct{
+    long long num_simulations;
+    long long timesteps;
+    long long pedestrian_steps; // Sum, over every timestep, of the pedestrians in the environment at its beginning.
+}Run_Statistics;
+
+Function_Status initialize_simulation_constants();
+Function_Status prepare_simulation_set();
+void deallocate_simulation_set_fields();
+int determine_number_of_pedestrians();
+Function_Status run_single_simulation(FILE *output_file, int simulation_index, int seed, int *number_timesteps);
+Function_Status allocate_run_statistics();
+void print_run_statistics(FILE *output_stream);
+void deallocate_run_statistics();
+
+#endif
@@ -2,9 +2,13 @@
 #define STATIC_FIELD_H
 
 #include"shared_resources.h"
+#include"exit.h"
 
-void calculate_kirchner_static_field(Location *exit_cell_coordinates, int num_exit_cells, Double_Grid destination_grid);
-void calculate_zheng_static_field(Location *exit_cell_coordinates, int num_exit_cells, Double_Grid destination_grid);
+void calculate_kirchner_static_field(Location *exit_cell_coordinates, int num_exit_cells, Field_Grid destination_grid);
+void calculate_zheng_static_field(Location *exit_cell_coordinates, int num_exit_cells, Field_Grid destination_grid);
+void compose_zheng_static_field(Field_Grid destination_grid);
+void remove_ignited_cells_from_zheng_static_field(Field_Grid destination_grid);
 Function_Status calculate_all_static_weights();
+Function_Status calculate_static_weight(Exit current_exit);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include<stdio.h>
+
+#include"shared_resources.h"
+
+Function_Status plan_parameter_sweep();
+Function_Status run_simulation_set(FILE *output_file);
+int count_simulation_set_jobs();
+Function_Status run_simulation_set_job(int set_job_index, int set_first_seed, int *number_timesteps);
+Function_Status print_simulation_set_job_results(FILE *output_file, int set_first_seed, const int *simulation_results);
+void deallocate_sweep_points();
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef WEIGHT_CACHE_H
+#define WEIGHT_CACHE_H
+
+#include<stdbool.h>
+#include<stdint.h>
+
+#include"shared_resources.h"
+#include"grid.h"
+
+typedef struct{
+    uint64_t hash; // FNV-1a hash, which names the cache file.
+    uint64_t check; // Independent hash of the same inputs, stored in the header of the file.
+}Static_Weight_Key;
+
+Static_Weight_Key calculate_static_weight_key(Field_Grid initial_static_weight);
+bool read_cached_static_weight(Static_Weight_Key key, Field_Grid static_weight);
+Function_Status write_cached_static_weight(Static_Weight_Key key, Field_Grid static_weight);
+
+#endif
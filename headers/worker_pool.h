@@ -0,0 +1,17 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include<stdbool.h>
+
+#include"shared_resources.h"
+
+typedef Function_Status (*Job_Function)(int job_index, int *job_result);
+
+// Receives the results of the first num_finished_jobs jobs, which are all finished.
+typedef Function_Status (*Progress_Function)(int num_finished_jobs, const int *job_results);
+
+Function_Status run_jobs(int num_jobs, Job_Function job, int *job_results);
+Function_Status run_jobs_with_progress(int num_jobs, Job_Function job, int *job_results, Progress_Function progress);
+bool are_workers_enabled();
+
+#endif
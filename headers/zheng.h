@@ -0,0 +1,40 @@
+#ifndef ZHENG_H
+#define ZHENG_H
+
+#include<stddef.h>
+
+#include"shared_resources.h"
+#include"grid.h"
+
+// In-process interface to the model (libzheng), for programs such as optimisers that run it many times with different
+// parameters or exits, and for the zheng program itself, which runs a context created from its command line arguments. The
+// model state is global, so a single context may exist at a time.
+typedef struct zheng_context *Zheng_Context;
+
+// Grids that may be read with zheng_get_field. The heatmap holds integers; the other grids hold Field_Value (see grid.h). The
+// static floor field is unnormalized (see zheng_get_static_field_normalizer).
+typedef enum{
+    ZHENG_STATIC_FLOOR_FIELD = 0,
+    ZHENG_DYNAMIC_FLOOR_FIELD,
+    ZHENG_FIRE_FLOOR_FIELD,
+    ZHENG_FIRE_DISTANCE_GRID,
+    ZHENG_HEATMAP_GRID,
+    ZHENG_NUM_FIELDS
+}Zheng_Field;
+
+// Receives, in order, the result of each replica run by zheng_run.
+typedef void (*Zheng_Replica_Callback)(int replica_index, int seed, int timesteps, void *user_data);
+
+Zheng_Context zheng_create_context(const char *environment, size_t environment_length, enum Environment_Origin environment_origin);
+Function_Status zheng_set_parameter(Zheng_Context context, const char *name, double value);
+Function_Status zheng_add_exit(Zheng_Context context, const Location *exit_cells, int num_exit_cells);
+Function_Status zheng_clear_exits(Zheng_Context context);
+Function_Status zheng_run(Zheng_Context context, int num_replicas, int first_seed, int *timesteps, Zheng_Replica_Callback callback, void *user_data);
+void *zheng_get_field(Zheng_Context context, Zheng_Field field, int *num_lines, int *num_columns);
+Function_Status zheng_get_static_field_normalizer(Zheng_Context context, double *normalizer);
+void zheng_destroy_context(Zheng_Context context);
+
+Zheng_Context zheng_create_context_from_arguments(int argc, char **argv);
+Function_Status zheng_run_simulation_sets(Zheng_Context context);
+
+#endif
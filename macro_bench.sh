@@ -0,0 +1,3 @@
+#!/bin/bash
+
+make -s release && python3 bench/macro_benchmark.py run --executable build/release/zheng.exe "$@"
@@ -0,0 +1,439 @@
+/*
+   File: zhengmodule.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the Python bindings of libzheng (see headers/zheng.h). A zheng.Context wraps the model context; its grids (static_floor_field, dynamic_floor_field, fire_floor_field, fire_distance_grid and heatmap_grid) are zheng.Grid objects, which export the memory of the model through the buffer protocol, so numpy.asarray(grid) or memoryview(grid) read them without copying. The static floor field is exported unnormalized, its sum being given by Context.static_field_normalizer. Context.run releases the GIL while the replicas are simulated.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include<Python.h>
+
+#include<stdbool.h>
+
+#include"../headers/zheng.h"
+
+// Buffer protocol format of the Field_Value of the floor fields (see grid.h).
+#ifdef FLOAT_FIELDS
+#define FIELD_VALUE_FORMAT "f"
+#else
+#define FIELD_VALUE_FORMAT "d"
+#endif
+
+typedef struct{
+    PyObject_HEAD
+    Zheng_Context context; // NULL after close.
+    int num_exports; // Number of buffers exported by the grids, which must be released before the floor fields are deallocated.
+    bool is_running; // True while run simulates, with the GIL released.
+}Context_Object;
+
+typedef struct{
+    PyObject_HEAD
+    Context_Object *owner;
+    Zheng_Field field;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+}Grid_Object;
+
+static const char *field_names[ZHENG_NUM_FIELDS] = {
+    "static_floor_field", "dynamic_floor_field", "fire_floor_field", "fire_distance_grid", "heatmap_grid"
+};
+
+static PyTypeObject Context_Type;
+static PyTypeObject Grid_Type;
+
+static bool is_context_usable(Context_Object *self);
+
+/**
+ * Creates the context: Context(environment, origin=2), where environment is the content (str or bytes) of an environment file
+ * and origin is the number given to the --origin option.
+ */
+static int context_init(Context_Object *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"environment", "origin", NULL};
+    const char *environment = NULL;
+    Py_ssize_t environment_length = 0;
+    int origin = STRUCTURE_AND_DOORS;
+
+    if(! PyArg_ParseTupleAndKeywords(args, kwargs, "s#|i", keywords, &environment, &environment_length, &origin))
+        return -1;
+
+    if(self->context != NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The context is already initialized.");
+        return -1;
+    }
+
+    self->context = zheng_create_context(environment, (size_t) environment_length, (enum Environment_Origin) origin);
+    if(self->context == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The context couldn't be created (a single context may exist at a time).");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void context_dealloc(Context_Object *self)
+{
+    zheng_destroy_context(self->context);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+/**
+ * set_parameter(name, value): sets a parameter of the model, by the name accepted by zheng_set_parameter.
+ */
+static PyObject *context_set_parameter(Context_Object *self, PyObject *args)
+{
+    const char *name = NULL;
+    double value = 0;
+
+    if(! PyArg_ParseTuple(args, "sd", &name, &value) || ! is_context_usable(self))
+        return NULL;
+
+    if(zheng_set_parameter(self->context, name, value) == FAILURE)
+    {
+        PyErr_Format(PyExc_ValueError, "Unknown parameter %s, or value outside its limits.", name);
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * add_exit(cells): adds an exit formed by the given cells, a sequence of (line, column) pairs.
+ */
+static PyObject *context_add_exit(Context_Object *self, PyObject *cells)
+{
+    if(! is_context_usable(self))
+        return NULL;
+
+    PyObject *cell_sequence = PySequence_Fast(cells, "The exit cells must be a sequence of (line, column) pairs.");
+    if(cell_sequence == NULL)
+        return NULL;
+
+    Py_ssize_t num_cells = PySequence_Fast_GET_SIZE(cell_sequence);
+    Location *exit_cells = PyMem_Malloc(sizeof(Location) * (num_cells > 0 ? num_cells : 1));
+    if(exit_cells == NULL)
+    {
+        Py_DECREF(cell_sequence);
+        return PyErr_NoMemory();
+    }
+
+    for(Py_ssize_t cell_index = 0; cell_index < num_cells; cell_index++)
+    {
+        PyObject *cell = PySequence_Fast_GET_ITEM(cell_sequence, cell_index);
+        if(! PyArg_ParseTuple(cell, "ii", &exit_cells[cell_index].lin, &exit_cells[cell_index].col))
+        {
+            PyMem_Free(exit_cells);
+            Py_DECREF(cell_sequence);
+            return NULL;
+        }
+    }
+
+    Function_Status status = zheng_add_exit(self->context, exit_cells, (int) num_cells);
+
+    PyMem_Free(exit_cells);
+    Py_DECREF(cell_sequence);
+
+    if(status == FAILURE)
+    {
+        PyErr_SetString(PyExc_ValueError, "Invalid exit cells.");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * clear_exits(): removes every exit. Fails while buffers of the grids are in use, since the floor fields are deallocated.
+ */
+static PyObject *context_clear_exits(Context_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    if(! is_context_usable(self))
+        return NULL;
+
+    if(self->num_exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "The exits can't be cleared while views of the grids exist.");
+        return NULL;
+    }
+
+    if(zheng_clear_exits(self->context) == FAILURE)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The exits couldn't be cleared.");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * run(num_replicas, first_seed=0): simulates num_replicas replicas, with consecutive seeds, and returns the list of their
+ * evacuation times, in timesteps, or None if an exit is inaccessible. The GIL is released while the replicas run.
+ */
+static PyObject *context_run(Context_Object *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"num_replicas", "first_seed", NULL};
+    int num_replicas = 0;
+    int first_seed = 0;
+
+    if(! PyArg_ParseTupleAndKeywords(args, kwargs, "i|i", keywords, &num_replicas, &first_seed) || ! is_context_usable(self))
+        return NULL;
+
+    if(num_replicas <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "The number of replicas must be positive.");
+        return NULL;
+    }
+
+    int *timesteps = PyMem_RawMalloc(sizeof(int) * num_replicas);
+    if(timesteps == NULL)
+        return PyErr_NoMemory();
+
+    Function_Status status;
+    self->is_running = true;
+    Py_BEGIN_ALLOW_THREADS
+    status = zheng_run(self->context, num_replicas, first_seed, timesteps, NULL, NULL);
+    Py_END_ALLOW_THREADS
+    self->is_running = false;
+
+    if(status != SUCCESS)
+    {
+        PyMem_RawFree(timesteps);
+        if(status == INACCESSIBLE_EXIT)
+            Py_RETURN_NONE;
+
+        PyErr_SetString(PyExc_RuntimeError, "The simulations failed.");
+        return NULL;
+    }
+
+    PyObject *results = PyList_New(num_replicas);
+    for(int replica_index = 0; results != NULL && replica_index < num_replicas; replica_index++)
+        PyList_SET_ITEM(results, replica_index, PyLong_FromLong(timesteps[replica_index]));
+
+    PyMem_RawFree(timesteps);
+
+    return results;
+}
+
+/**
+ * close(): destroys the model context, so another one may be created. Fails while buffers of the grids are in use.
+ */
+static PyObject *context_close(Context_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    if(self->is_running)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The context is running.");
+        return NULL;
+    }
+
+    if(self->num_exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "The context can't be closed while views of the grids exist.");
+        return NULL;
+    }
+
+    zheng_destroy_context(self->context);
+    self->context = NULL;
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * Getter of the grids, which returns a zheng.Grid bound to this context.
+ */
+static PyObject *context_get_grid(Context_Object *self, void *field)
+{
+    if(! is_context_usable(self))
+        return NULL;
+
+    Grid_Object *grid = PyObject_New(Grid_Object, &Grid_Type);
+    if(grid == NULL)
+        return NULL;
+
+    Py_INCREF(self);
+    grid->owner = self;
+    grid->field = (Zheng_Field) (Py_intptr_t) field;
+
+    return (PyObject *) grid;
+}
+
+/**
+ * Getter of static_field_normalizer: the sum by which the cells of static_floor_field must be divided to be normalized.
+ */
+static PyObject *context_get_static_field_normalizer(Context_Object *self, void *Py_UNUSED(closure))
+{
+    if(! is_context_usable(self))
+        return NULL;
+
+    double normalizer = 0;
+    if(zheng_get_static_field_normalizer(self->context, &normalizer) == FAILURE)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The static_floor_field isn't allocated (the floor fields are allocated by the first run after the exits are set).");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(normalizer);
+}
+
+static void grid_dealloc(Grid_Object *self)
+{
+    Py_XDECREF(self->owner);
+    PyObject_Free(self);
+}
+
+/**
+ * Exports the cells of the grid, as a read-write C-contiguous two-dimensional buffer of Field_Value (doubles, 'd', or floats, 'f',
+ * when built with FIELDS=float) or, for the heatmap, ints ('i').
+ */
+static int grid_get_buffer(Grid_Object *self, Py_buffer *view, int flags)
+{
+    int num_lines = 0, num_columns = 0;
+
+    if(! is_context_usable(self->owner))
+    {
+        view->obj = NULL;
+        return -1;
+    }
+
+    void *cells = zheng_get_field(self->owner->context, self->field, &num_lines, &num_columns);
+    if(cells == NULL)
+    {
+        PyErr_Format(PyExc_BufferError, "The %s isn't allocated (the floor fields are allocated by the first run after the exits are set).",
+                     field_names[self->field]);
+        view->obj = NULL;
+        return -1;
+    }
+
+    bool is_integer_grid = self->field == ZHENG_HEATMAP_GRID;
+    Py_ssize_t item_size = is_integer_grid ? sizeof(int) : sizeof(Field_Value);
+
+    self->shape[0] = num_lines;
+    self->shape[1] = num_columns;
+    self->strides[0] = num_columns * item_size;
+    self->strides[1] = item_size;
+
+    view->buf = cells;
+    view->obj = (PyObject *) self;
+    view->len = num_lines * num_columns * item_size;
+    view->readonly = 0;
+    view->itemsize = item_size;
+    view->format = (flags & PyBUF_FORMAT) ? (is_integer_grid ? "i" : FIELD_VALUE_FORMAT) : NULL;
+    view->ndim = 2;
+    view->shape = self->shape;
+    view->strides = self->strides;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    Py_INCREF(self);
+    self->owner->num_exports++;
+
+    return 0;
+}
+
+static void grid_release_buffer(Grid_Object *self, Py_buffer *view)
+{
+    self->owner->num_exports--;
+}
+
+static PyMethodDef context_methods[] = {
+    {"set_parameter", (PyCFunction) context_set_parameter, METH_VARARGS, "set_parameter(name, value): sets a parameter of the model."},
+    {"add_exit", (PyCFunction) context_add_exit, METH_O, "add_exit(cells): adds an exit formed by a sequence of (line, column) cells."},
+    {"clear_exits", (PyCFunction) context_clear_exits, METH_NOARGS, "clear_exits(): removes every exit."},
+    {"run", (PyCFunction) context_run, METH_VARARGS | METH_KEYWORDS,
+     "run(num_replicas, first_seed=0): returns the evacuation times of the replicas, or None if an exit is inaccessible."},
+    {"close", (PyCFunction) context_close, METH_NOARGS, "close(): destroys the context, so another one may be created."},
+    {NULL}
+};
+
+static PyGetSetDef context_grids[] = {
+    {"static_floor_field", (getter) context_get_grid, NULL, "Static floor field, unnormalized.", (void *) ZHENG_STATIC_FLOOR_FIELD},
+    {"static_field_normalizer", (getter) context_get_static_field_normalizer, NULL, "Sum by which the static floor field is normalized.", NULL},
+    {"dynamic_floor_field", (getter) context_get_grid, NULL, "Dynamic floor field.", (void *) ZHENG_DYNAMIC_FLOOR_FIELD},
+    {"fire_floor_field", (getter) context_get_grid, NULL, "Fire floor field.", (void *) ZHENG_FIRE_FLOOR_FIELD},
+    {"fire_distance_grid", (getter) context_get_grid, NULL, "Distance from each cell to the fire.", (void *) ZHENG_FIRE_DISTANCE_GRID},
+    {"heatmap_grid", (getter) context_get_grid, NULL, "Pedestrian counts of the last run.", (void *) ZHENG_HEATMAP_GRID},
+    {NULL}
+};
+
+static PyBufferProcs grid_buffer_procs = {
+    .bf_getbuffer = (getbufferproc) grid_get_buffer,
+    .bf_releasebuffer = (releasebufferproc) grid_release_buffer
+};
+
+static PyTypeObject Context_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "zheng.Context",
+    .tp_basicsize = sizeof(Context_Object),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Context(environment, origin=2): the model, with the environment given by the content of an environment file.",
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc) context_init,
+    .tp_dealloc = (destructor) context_dealloc,
+    .tp_methods = context_methods,
+    .tp_getset = context_grids
+};
+
+static PyTypeObject Grid_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "zheng.Grid",
+    .tp_basicsize = sizeof(Grid_Object),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "A grid of the model, read without copying through the buffer protocol (numpy.asarray or memoryview).",
+    .tp_dealloc = (destructor) grid_dealloc,
+    .tp_as_buffer = &grid_buffer_procs
+};
+
+static struct PyModuleDef zheng_module = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "zheng",
+    .m_doc = "Bindings of the Zheng pedestrian evacuation model.",
+    .m_size = -1
+};
+
+PyMODINIT_FUNC PyInit_zheng()
+{
+    if(PyType_Ready(&Context_Type) < 0 || PyType_Ready(&Grid_Type) < 0)
+        return NULL;
+
+    PyObject *module = PyModule_Create(&zheng_module);
+    if(module == NULL)
+        return NULL;
+
+    Py_INCREF(&Context_Type);
+    if(PyModule_AddObject(module, "Context", (PyObject *) &Context_Type) < 0)
+    {
+        Py_DECREF(&Context_Type);
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    return module;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Verifies if the context may be used, setting a Python exception if it can't.
+ *
+ * @param self The context.
+ * @return True, if the context is open and not running, or False otherwise.
+ */
+static bool is_context_usable(Context_Object *self)
+{
+    if(self->context == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The context is closed.");
+        return false;
+    }
+
+    if(self->is_running)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The context is running.");
+        return false;
+    }
+
+    return true;
+}
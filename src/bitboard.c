@@ -0,0 +1,168 @@
+/*
+   File: bitboard.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains bitboards, grids with one bit per cell stored as 64-bit words (each line starts at a new word), and the operations on whole sets of cells that they allow a word at a time: the dilation of a set of cells in the Moore neighborhood, as done by the spread of the fire, and the listing of the cells of a set.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"../headers/bitboard.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+static uint64_t dilate_line_word(const uint64_t *line, int word_index, int num_words);
+
+/**
+ * Dynamically allocates a bitboard of dimensions determined by the function parameters.
+ *
+ * @param line_number Number of lines of the bitboard.
+ * @param column_number Number of columns of the bitboard.
+ * @return A NULL pointer, on error, or a Bitboard if it was successfully allocated.
+ *
+ * @note All bits are already zeroed, including those after the last column of each line, which must stay zeroed.
+ * @note The words are stored in a single contiguous block (line after line), pointed by the first line, so the bitboard is deallocated with deallocate_grid.
+ */
+Bitboard allocate_bitboard(int line_number, int column_number)
+{
+    if(line_number <= 0 || column_number <= 0)
+    {
+        fprintf(stderr, "At least one of the bitboard dimensions was negative or zero.\n");
+        return NULL;
+    }
+
+    int num_words = BITBOARD_WORDS(column_number);
+
+    Bitboard new_bitboard = malloc(sizeof(uint64_t *) * line_number);
+    if(new_bitboard == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for the lines of a bitboard.\n");
+        return NULL;
+    }
+
+    new_bitboard[0] = calloc((size_t) line_number * num_words, sizeof(uint64_t));
+    if(new_bitboard[0] == NULL)
+    {
+        free(new_bitboard);
+
+        fprintf(stderr, "Failed to allocate memory for the words of a bitboard.\n");
+        return NULL;
+    }
+
+    for(int i = 1; i < line_number; i++)
+        new_bitboard[i] = new_bitboard[0] + (size_t) i * num_words;
+
+    return new_bitboard;
+}
+
+/**
+ * Sets the bit of the given cell.
+ *
+ * @param bitboard The bitboard.
+ * @param cell The cell.
+ */
+void set_bitboard_cell(Bitboard bitboard, Location cell)
+{
+    bitboard[cell.lin][cell.col / BITS_PER_WORD] |= (uint64_t) 1 << (cell.col % BITS_PER_WORD);
+}
+
+/**
+ * Dilates the cells of the source in the Moore neighborhood, keeping only the cells of the mask: a cell of the mask is set in
+ * the destination if any of its eight neighbors (or the cell itself) is set in the source. Each word is obtained with shifts and
+ * ORs of the words of the three lines around it, so 64 cells are dilated at once.
+ *
+ * @note Only the lines of the source within the given range, and their neighbor lines, are visited. The other lines of the
+ * destination aren't written, so they must be already zeroed.
+ *
+ * @param destination Bitboard where the dilation is stored, which must be distinct from the source.
+ * @param source Bitboard with the cells to be dilated.
+ * @param mask Bitboard with the cells the dilation may reach.
+ * @param first_line Pointer to the first line of the source with set cells, where the first line of the destination with set cells is stored.
+ * @param last_line Pointer to the last line of the source with set cells, where the last line of the destination with set cells is stored.
+ * @return bool, where True indicates that the destination has at least one cell, or False otherwise.
+ */
+bool dilate_bitboard(Bitboard destination, Bitboard source, Bitboard mask, int *first_line, int *last_line)
+{
+    int num_words = BITBOARD_WORDS(cli_args.global_column_number);
+    int first_dilated_line = *first_line > 0 ? *first_line - 1 : 0;
+    int last_dilated_line = *last_line < cli_args.global_line_number - 1 ? *last_line + 1 : cli_args.global_line_number - 1;
+    int source_first_line = *first_line, source_last_line = *last_line;
+
+    *first_line = cli_args.global_line_number;
+    *last_line = -1;
+    for(int i = first_dilated_line; i <= last_dilated_line; i++)
+    {
+        int first_neighbor_line = i > source_first_line ? i - 1 : source_first_line;
+        int last_neighbor_line = i < source_last_line ? i + 1 : source_last_line;
+        uint64_t line_cells = 0;
+
+        for(int w = 0; w < num_words; w++)
+        {
+            uint64_t dilation = 0;
+
+            for(int line = first_neighbor_line; line <= last_neighbor_line; line++)
+                dilation |= dilate_line_word(source[line], w, num_words);
+
+            destination[i][w] = dilation & mask[i][w];
+            line_cells |= destination[i][w];
+        }
+
+        if(line_cells != 0)
+        {
+            if(*first_line > i)
+                *first_line = i;
+            *last_line = i;
+        }
+    }
+
+    return *last_line >= 0;
+}
+
+/**
+ * Lists the set cells of the given lines of the bitboard, line after line.
+ *
+ * @param bitboard The bitboard.
+ * @param first_line First line to be listed.
+ * @param last_line Last line to be listed.
+ * @param cells Array where the cells are stored, with room for every set cell.
+ * @return The number of cells stored.
+ */
+int extract_bitboard_cells(Bitboard bitboard, int first_line, int last_line, Location *cells)
+{
+    int num_words = BITBOARD_WORDS(cli_args.global_column_number);
+    int num_cells = 0;
+
+    for(int i = first_line; i <= last_line; i++)
+    {
+        for(int w = 0; w < num_words; w++)
+        {
+            for(uint64_t word = bitboard[i][w]; word != 0; word &= word - 1) // Clears the lowest set bit at each iteration.
+                cells[num_cells++] = (Location) {i, w * BITS_PER_WORD + __builtin_ctzll(word)};
+        }
+    }
+
+    return num_cells;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Dilates a word of a line in the horizontal direction: each set cell also sets its left and right neighbors, carrying the
+ * bits that cross to the neighbor words.
+ *
+ * @param line The words of the line.
+ * @param word_index Index of the word to be dilated.
+ * @param num_words Number of words of the line.
+ * @return The dilated word.
+ */
+static uint64_t dilate_line_word(const uint64_t *line, int word_index, int num_words)
+{
+    uint64_t word = line[word_index];
+    uint64_t previous_word = word_index > 0 ? line[word_index - 1] : 0;
+    uint64_t next_word = word_index < num_words - 1 ? line[word_index + 1] : 0;
+
+    return word | (word << 1) | (previous_word >> (BITS_PER_WORD - 1)) | (word >> 1) | (next_word << (BITS_PER_WORD - 1));
+}
@@ -0,0 +1,96 @@
+/*
+   File: cell_graph.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the walkable graph of a simulation set: the cells where the fields are defined (the empty cells and the exit cells), numbered line after line, with the position of each one in the contiguous block of the grids, the indices of its neighbors in the von Neumann neighborhood and the list of cells where pedestrians may be inserted at random. The kernels that only read or write these cells (static field, fire floor field, diffusion and pedestrian movement) iterate over the graph instead of the whole grid, without testing for walls and obstacles.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"../headers/cell_graph.h"
+#include"../headers/exit.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+Cell_Graph walkable_graph = {0, NULL, NULL, NULL, NULL, 0, NULL};
+
+/**
+ * Builds the walkable graph of the current simulation set, whose cells are those without WALL_STATE and the exit cells
+ * (blocked or not) of the cell_state_grid. Every other cell is a wall or an obstacle, where the static field is IMPASSABLE_OBJECT.
+ * The insertion cells are listed once here, so every simulation of the set (and every density swept) reuses them.
+ *
+ * @note Must be called after the exits of the simulation set are placed. A blocked exit stays in the graph, as in the static field.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status build_walkable_graph()
+{
+    deallocate_walkable_graph();
+
+    int num_grid_cells = cli_args.global_line_number * cli_args.global_column_number;
+
+    walkable_graph.cells = malloc(sizeof(Location) * num_grid_cells);
+    walkable_graph.offsets = malloc(sizeof(int) * num_grid_cells);
+    walkable_graph.von_neumann_neighbors = malloc(sizeof(int) * 4 * num_grid_cells);
+    walkable_graph.index_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
+    walkable_graph.insertion_cells = malloc(sizeof(int) * num_grid_cells);
+    if(walkable_graph.cells == NULL || walkable_graph.offsets == NULL || walkable_graph.von_neumann_neighbors == NULL || walkable_graph.index_grid == NULL ||
+       walkable_graph.insertion_cells == NULL)
+    {
+        fprintf(stderr, "Failure during the allocation of the walkable graph.\n");
+        return FAILURE;
+    }
+
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+        {
+            walkable_graph.index_grid[i][j] = NO_NEIGHBOR;
+
+            if((cell_state_grid[i][j] & WALL_STATE) && ! (cell_state_grid[i][j] & ANY_EXIT_STATE))
+                continue;
+
+            walkable_graph.index_grid[i][j] = walkable_graph.num_cells;
+            walkable_graph.cells[walkable_graph.num_cells] = (Location) {i,j};
+            walkable_graph.offsets[walkable_graph.num_cells] = i * cli_args.global_column_number + j;
+
+            if(! (cell_state_grid[i][j] & ANY_EXIT_STATE) && i > 0 && i < cli_args.global_line_number - 1 && j > 0 && j < cli_args.global_column_number - 1)
+                walkable_graph.insertion_cells[walkable_graph.num_insertion_cells++] = walkable_graph.num_cells;
+
+            walkable_graph.num_cells++;
+        }
+    }
+
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
+    {
+        Location cell = walkable_graph.cells[cell_index];
+
+        for(int n = 0; n < 4; n++)
+        {
+            int lin = cell.lin + non_diagonal_modifiers[n].lin;
+            int col = cell.col + non_diagonal_modifiers[n].col;
+
+            if(! is_within_grid_lines(lin) || ! is_within_grid_columns(col))
+                walkable_graph.von_neumann_neighbors[4 * cell_index + n] = NO_NEIGHBOR;
+            else
+                walkable_graph.von_neumann_neighbors[4 * cell_index + n] = walkable_graph.index_grid[lin][col];
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Deallocates the walkable graph.
+ */
+void deallocate_walkable_graph()
+{
+    free(walkable_graph.cells);
+    free(walkable_graph.offsets);
+    free(walkable_graph.von_neumann_neighbors);
+    deallocate_grid((void **) walkable_graph.index_grid, cli_args.global_line_number);
+    free(walkable_graph.insertion_cells);
+
+    walkable_graph = (Cell_Graph) {0, NULL, NULL, NULL, NULL, 0, NULL};
+}
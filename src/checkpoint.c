@@ -0,0 +1,459 @@
+/*
+   File: checkpoint.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains functions to capture the full state of a running simulation (fire, pedestrians, floor fields, blocked exits and the random number generator) in a single contiguous block, to restore it and to store it in binary checkpoint files, allowing many continuations to branch from a single warm-up.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+
+#include"../headers/checkpoint.h"
+#include"../headers/grid.h"
+#include"../headers/exit.h"
+#include"../headers/pedestrian.h"
+#include"../headers/fire_field.h"
+#include"../headers/fire_dynamics.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+#define CHECKPOINT_IDENTIFIER "ZHENGCKP"
+#define CHECKPOINT_VERSION 3
+#define RANDOM_STATE_SIZE 128 // Bytes of state used by glibc's default generator (TYPE_3).
+
+// Values of the risky cells block, one int per cell, as stored before the cell_state_grid was introduced.
+#define STORED_NON_RISKY_CELL 0
+#define STORED_RISKY_CELL 1
+#define STORED_DANGER_CELL 2
+
+struct simulation_state {
+    char identifier[8];
+    int version;
+    int line_number;
+    int column_number;
+    int num_exits;
+    int num_exit_cells;
+    int num_pedestrians;
+    int num_dead_pedestrians;
+    int timesteps;
+    int has_the_fire_spread;
+    size_t data_size;
+    unsigned char data[]; // Grids, blocked flags, pedestrians, generator state and exit cells, in the order used by transfer_state_data.
+};
+
+const char *checkpoint_path = "checkpoints/";
+
+static void transfer_state_data(unsigned char *data, bool is_capture);
+static void transfer_block(unsigned char **cursor, void *block, size_t size, bool is_capture);
+static void transfer_risky_cells(unsigned char **cursor, bool is_capture);
+static void mark_occupied_cells();
+static size_t calculate_state_data_size(int num_pedestrians);
+static int count_exit_cells();
+static bool has_same_exit_cells(Simulation_State state);
+
+// The state of rand() lives in one of these buffers (see initialize_random_state). Two are needed because setstate writes the
+// position of the generator being replaced into its buffer before reading the new one, which would overwrite a restored state.
+static int32_t random_states[2][RANDOM_STATE_SIZE / sizeof(int32_t)];
+static int active_random_state = 0;
+
+/**
+ * Moves the state of the random number generator to a buffer owned by this module, so it can be captured and restored.
+ *
+ * @note The buffer has the size of glibc's default state, so srand and rand produce the same sequences as before. Must be called before any call to srand.
+ */
+void initialize_random_state()
+{
+    initstate(1, (char *) random_states[active_random_state], RANDOM_STATE_SIZE);
+}
+
+/**
+ * Captures the state of the simulation being run.
+ *
+ * @note The heatmap is not part of the state: the counts made before the capture belong to the simulation that was captured.
+ *
+ * @param timesteps Number of timesteps already run.
+ * @param has_the_fire_spread Whether the fire has spread in the last timestep (and the static field still needs recalculation).
+ * @return A Simulation_State (to be deallocated with deallocate_simulation_state), or NULL in case of failure.
+ */
+Simulation_State capture_simulation_state(int timesteps, bool has_the_fire_spread)
+{
+    size_t data_size = calculate_state_data_size(pedestrian_set.num_pedestrians);
+
+    Simulation_State state = malloc(sizeof(struct simulation_state) + data_size);
+    if(state == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the simulation state.\n");
+        return NULL;
+    }
+
+    memcpy(state->identifier, CHECKPOINT_IDENTIFIER, sizeof(state->identifier));
+    state->version = CHECKPOINT_VERSION;
+    state->line_number = cli_args.global_line_number;
+    state->column_number = cli_args.global_column_number;
+    state->num_exits = exits_set.num_exits;
+    state->num_exit_cells = count_exit_cells();
+    state->num_pedestrians = pedestrian_set.num_pedestrians;
+    state->num_dead_pedestrians = pedestrian_set.num_dead_pedestrians;
+    state->timesteps = timesteps;
+    state->has_the_fire_spread = has_the_fire_spread;
+    state->data_size = data_size;
+
+    setstate((char *) random_states[active_random_state]); // Stores the position of the generator within its buffer.
+    transfer_state_data(state->data, true);
+
+    return state;
+}
+
+/**
+ * Restores a captured state, replacing the pedestrians, fire, floor fields, blocked exits and the random number generator of the current simulation.
+ *
+ * @note The state must be compatible with the current simulation set (see is_state_compatible).
+ *
+ * @param state The state to be restored.
+ * @param timesteps Pointer to an integer, where the number of timesteps already run will be stored.
+ * @param has_the_fire_spread Pointer to a bool, where the fire spread flag of the captured timestep will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status restore_simulation_state(Simulation_State state, int *timesteps, bool *has_the_fire_spread)
+{
+    if(pedestrian_set.num_pedestrians != state->num_pedestrians)
+    {
+        deallocate_pedestrians();
+
+        pedestrian_set.list = calloc(state->num_pedestrians, sizeof(Pedestrian));
+        if(pedestrian_set.list == NULL)
+        {
+            fprintf(stderr, "Failure to allocate the pedestrian_set list while restoring a simulation state.\n");
+            return FAILURE;
+        }
+        pedestrian_set.num_pedestrians = pedestrian_set.list_capacity = state->num_pedestrians;
+    }
+
+    for(int p_index = 0; p_index < pedestrian_set.num_pedestrians; p_index++)
+    {
+        if(pedestrian_set.list[p_index] == NULL)
+        {
+            pedestrian_set.list[p_index] = malloc(sizeof(struct pedestrian));
+            if(pedestrian_set.list[p_index] == NULL)
+            {
+                fprintf(stderr, "Failure to allocate a pedestrian while restoring a simulation state.\n");
+                return FAILURE;
+            }
+        }
+    }
+
+    pedestrian_set.num_dead_pedestrians = state->num_dead_pedestrians;
+
+    reset_exits(); // The exits blocked in the restored state are marked again by transfer_state_data.
+
+    int next_random_state = 1 - active_random_state;
+    transfer_state_data(state->data, false);
+    setstate((char *) random_states[next_random_state]);
+    active_random_state = next_random_state;
+
+    *timesteps = state->timesteps;
+    *has_the_fire_spread = state->has_the_fire_spread;
+
+    // A fire that can't grow is the same before and after the first spread, which must still be followed by the update of the blocked exits.
+    if(current_fire_epoch == 0 && *has_the_fire_spread)
+        current_fire_epoch = 1;
+
+    return SUCCESS;
+}
+
+/**
+ * Verifies if a state can be restored in the current simulation set, i.e., if the environment dimensions and the exits (down to
+ * the coordinates of their cells) are the same, and if its fire is one of the epochs of the fire of the environment.
+ *
+ * @note The fields are stored as Field_Value, so the states captured by a program built with the other field scalar are
+ * rejected by the size of their data area.
+ *
+ * @param state The state to be verified.
+ * @return bool, where True indicates that the state is compatible and False otherwise.
+ */
+bool is_state_compatible(Simulation_State state)
+{
+    return state->line_number == cli_args.global_line_number &&
+           state->column_number == cli_args.global_column_number &&
+           state->num_exits == exits_set.num_exits &&
+           state->num_exit_cells == count_exit_cells() &&
+           state->data_size == calculate_state_data_size(state->num_pedestrians) &&
+           has_same_exit_cells(state) &&
+           find_fire_epoch((const int *) state->data) >= 0; // The fire is the first block of the data area.
+}
+
+/**
+ * Writes a state to a checkpoint file, placed in the checkpoints directory.
+ *
+ * @param state The state to be written.
+ * @param filename Name of the checkpoint file.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status write_simulation_state(Simulation_State state, const char *filename)
+{
+    char complete_path[300] = "";
+    sprintf(complete_path, "%s%s", checkpoint_path, filename);
+
+    FILE *checkpoint_file = fopen(complete_path, "wb");
+    if(checkpoint_file == NULL)
+    {
+        fprintf(stderr, "It was not possible to open the checkpoint file %s for writing.\n", complete_path);
+        return FAILURE;
+    }
+
+    size_t written = fwrite(state, sizeof(struct simulation_state) + state->data_size, 1, checkpoint_file);
+    if(fclose(checkpoint_file) != 0 || written != 1)
+    {
+        fprintf(stderr, "Failure while writing the checkpoint file %s.\n", complete_path);
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Reads a state from a checkpoint file, placed in the checkpoints directory.
+ *
+ * @param filename Name of the checkpoint file.
+ * @return A Simulation_State (to be deallocated with deallocate_simulation_state), or NULL in case of failure.
+ */
+Simulation_State read_simulation_state(const char *filename)
+{
+    char complete_path[300] = "";
+    struct simulation_state header;
+
+    sprintf(complete_path, "%s%s", checkpoint_path, filename);
+
+    FILE *checkpoint_file = fopen(complete_path, "rb");
+    if(checkpoint_file == NULL)
+    {
+        fprintf(stderr, "It was not possible to open the checkpoint file %s.\n", complete_path);
+        return NULL;
+    }
+
+    if(fread(&header, sizeof(struct simulation_state), 1, checkpoint_file) != 1 ||
+       memcmp(header.identifier, CHECKPOINT_IDENTIFIER, sizeof(header.identifier)) != 0 ||
+       header.version != CHECKPOINT_VERSION)
+    {
+        fprintf(stderr, "The file %s is not a valid checkpoint.\n", complete_path);
+        fclose(checkpoint_file);
+        return NULL;
+    }
+
+    Simulation_State state = malloc(sizeof(struct simulation_state) + header.data_size);
+    if(state == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the simulation state.\n");
+        fclose(checkpoint_file);
+        return NULL;
+    }
+
+    *state = header;
+    if(fread(state->data, header.data_size, 1, checkpoint_file) != 1)
+    {
+        fprintf(stderr, "The checkpoint file %s is truncated.\n", complete_path);
+        free(state);
+        state = NULL;
+    }
+
+    fclose(checkpoint_file);
+
+    return state;
+}
+
+/**
+ * Deallocates a state.
+ *
+ * @param state The state to be deallocated.
+ */
+void deallocate_simulation_state(Simulation_State state)
+{
+    free(state);
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Copies every block of the simulation state between the program structures and the data area of a Simulation_State.
+ *
+ * @note When restoring, the generator state is copied to the inactive buffer of random_states, and the pedestrian_set must already hold the right number of allocated pedestrians.
+ *
+ * @param data Data area of the Simulation_State.
+ * @param is_capture If true, copies from the program structures to data; otherwise, from data to the program structures.
+ */
+static void transfer_state_data(unsigned char *data, bool is_capture)
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+    unsigned char *cursor = data;
+
+    // The fire is stored cell by cell, and restored as the epoch where it is found.
+    if(is_capture)
+        write_fire_cells((int *) cursor);
+    else
+    {
+        current_fire_epoch = find_fire_epoch((const int *) cursor);
+        mark_fire_cells();
+    }
+    cursor += sizeof(int) * num_cells;
+
+    transfer_risky_cells(&cursor, is_capture);
+    transfer_block(&cursor, pedestrian_position_grid[0], sizeof(int) * num_cells, is_capture);
+    if(! is_capture)
+        mark_occupied_cells();
+    transfer_block(&cursor, fire_distance_grid[0], sizeof(Field_Value) * num_cells, is_capture);
+    transfer_block(&cursor, exits_set.dynamic_floor_field[0], sizeof(Field_Value) * num_cells, is_capture);
+    transfer_block(&cursor, exits_set.fire_floor_field[0], sizeof(Field_Value) * num_cells, is_capture);
+    transfer_block(&cursor, exits_set.static_floor_field[0], sizeof(Field_Value) * num_cells, is_capture);
+    transfer_block(&cursor, &exits_set.static_field_normalizer, sizeof(double), is_capture);
+    transfer_block(&cursor, exits_set.distance_to_exits_grid[0], sizeof(Field_Value) * num_cells, is_capture);
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+    {
+        Exit current_exit = exits_set.list[exit_index];
+        transfer_block(&cursor, &current_exit->is_blocked_by_fire, sizeof(bool), is_capture);
+
+        if(! is_capture && current_exit->is_blocked_by_fire)
+            mark_exit_as_blocked(current_exit);
+    }
+
+    for(int p_index = 0; p_index < pedestrian_set.num_pedestrians; p_index++)
+        transfer_block(&cursor, pedestrian_set.list[p_index], sizeof(struct pedestrian), is_capture);
+
+    int random_state_index = is_capture ? active_random_state : 1 - active_random_state;
+    transfer_block(&cursor, random_states[random_state_index], RANDOM_STATE_SIZE, is_capture);
+
+    // The exit cells are only stored, to be compared by has_same_exit_cells. The restored exits are those of the simulation set.
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+    {
+        Exit current_exit = exits_set.list[exit_index];
+        if(is_capture)
+            memcpy(cursor, current_exit->coordinates, sizeof(Location) * current_exit->width);
+        cursor += sizeof(Location) * current_exit->width;
+    }
+}
+
+/**
+ * Copies a block between the program structures and the position of the data area pointed by cursor, advancing the cursor.
+ *
+ * @param cursor Pointer to the current position in the data area.
+ * @param block The block within the program structures.
+ * @param size Size of the block, in bytes.
+ * @param is_capture If true, copies from block to the data area; otherwise, from the data area to block.
+ */
+static void transfer_block(unsigned char **cursor, void *block, size_t size, bool is_capture)
+{
+    if(is_capture)
+        memcpy(*cursor, block, size);
+    else
+        memcpy(block, *cursor, size);
+
+    *cursor += size;
+}
+
+/**
+ * Copies the risky and danger cells between the cell_state_grid and the position of the data area pointed by cursor, where
+ * they are stored as one int per cell (see STORED_RISKY_CELL), advancing the cursor.
+ *
+ * @param cursor Pointer to the current position in the data area.
+ * @param is_capture If true, copies from the cell_state_grid to the data area; otherwise, from the data area to the cell_state_grid.
+ */
+static void transfer_risky_cells(unsigned char **cursor, bool is_capture)
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+    uint8_t *cell_states = cell_state_grid[0];
+    int stored_cell = STORED_NON_RISKY_CELL;
+
+    for(size_t k = 0; k < num_cells; k++, *cursor += sizeof(int))
+    {
+        if(is_capture)
+        {
+            stored_cell = (cell_states[k] & RISKY_STATE) ? STORED_RISKY_CELL : (cell_states[k] & DANGER_STATE) ? STORED_DANGER_CELL : STORED_NON_RISKY_CELL;
+            memcpy(*cursor, &stored_cell, sizeof(int));
+            continue;
+        }
+
+        memcpy(&stored_cell, *cursor, sizeof(int));
+        cell_states[k] &= ~(RISKY_STATE | DANGER_STATE);
+        if(stored_cell == STORED_RISKY_CELL)
+            cell_states[k] |= RISKY_STATE;
+        else if(stored_cell == STORED_DANGER_CELL)
+            cell_states[k] |= DANGER_STATE;
+    }
+}
+
+/**
+ * Marks with OCCUPIED_STATE, in the cell_state_grid, the cells of the restored pedestrian_position_grid that hold a pedestrian.
+ */
+static void mark_occupied_cells()
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+
+    clear_cell_state_flags(cell_state_grid, OCCUPIED_STATE);
+    for(size_t k = 0; k < num_cells; k++)
+    {
+        if(pedestrian_position_grid[0][k] != 0)
+            cell_state_grid[0][k] |= OCCUPIED_STATE;
+    }
+}
+
+/**
+ * Calculates the size of the data area of a Simulation_State for the current environment and exits.
+ *
+ * @param num_pedestrians Number of pedestrians in the state.
+ * @return The size, in bytes.
+ */
+static size_t calculate_state_data_size(int num_pedestrians)
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+
+    return num_cells * (3 * sizeof(int) + 5 * sizeof(Field_Value)) +
+           exits_set.num_exits * sizeof(bool) +
+           num_pedestrians * sizeof(struct pedestrian) +
+           sizeof(double) + // The normalizer of the static floor field.
+           RANDOM_STATE_SIZE +
+           count_exit_cells() * sizeof(Location);
+}
+
+/**
+ * Counts the cells of all exits of the current simulation set.
+ *
+ * @return The number of exit cells.
+ */
+static int count_exit_cells()
+{
+    int num_exit_cells = 0;
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+        num_exit_cells += exits_set.list[exit_index]->width;
+
+    return num_exit_cells;
+}
+
+/**
+ * Verifies if the exit cells stored at the end of the data area of a state are the cells of the exits of the current
+ * simulation set, exit by exit and in the same order.
+ *
+ * @note The state must have the data size of the current simulation set, so the cells are found at the expected position.
+ *
+ * @param state The state to be verified.
+ * @return bool, where True indicates that the exit cells are the same and False otherwise.
+ */
+static bool has_same_exit_cells(Simulation_State state)
+{
+    const unsigned char *cursor = state->data + state->data_size - count_exit_cells() * sizeof(Location);
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+    {
+        Exit current_exit = exits_set.list[exit_index];
+        if(memcmp(cursor, current_exit->coordinates, sizeof(Location) * current_exit->width) != 0)
+            return false;
+
+        cursor += sizeof(Location) * current_exit->width;
+    }
+
+    return true;
+}
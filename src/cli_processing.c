@@ -20,6 +20,7 @@ const char doc[] = "zheng - Simulates pedestrian evacuation using the Zheng (201
 "\v"
 "If no file is provided with --env-file, the varas_queue.txt file will be used.\n"
 "The file provided with --auxiliary-file must contain, on each line, the coordinates of the exits for a single simulation set. The syntax to be used is described in the project's readme.\n"
+"The file provided with --sweep-file lists the constants to be swept (ks, kd, kf, omega, mu, fire_alpha and spread_rate) and their ranges. Its syntax is also described in the project's readme. With the timesteps output format, one line is written per (parameters, seed) result.\n"
 "\n"
 "The --env-load-method option specifies whether the environment will be created or loaded from the file provided by --env-file, as well as how it will be loaded if applicable. The following choices are available:\n"
 "\tEnvironment loaded from a file:\n"
@@ -36,6 +37,11 @@ const char doc[] = "zheng - Simulates pedestrian evacuation using the Zheng (201
 "\t 2 -           Number of timesteps required for the termination of each simulation.\n"
 "\t 3 -           Heatmap of the environment cells.\n"
 "\n"
+"The --combination-rule option specifies how the candidate doors of --door-combinations are combined in the simulation sets. The following choices are available:\n"
+"\t 1 - (default) Combinations: distinct doors, each group of doors appearing once.\n"
+"\t 2 -           Permutations: distinct doors, each group of doors appearing in every order.\n"
+"\t 3 -           Product: any doors, in every order. A door combined with itself gives a single-exit simulation set.\n"
+"\n"
 "The --dyn-definition option specifies how the dynamic floor field is defined, either as a particle density field or a velocity density field. In the particle density field, pedestrians leave particles in the cell they occupy (before any movement is attempted). In the velocity density field, they leave a particle only in their previous location when they move. The following choices are available:\n"
 "\t 1 - (default) Velocity Density Field.\n"
 "\t 2 -           Particle Density Field.\n"
@@ -69,6 +75,19 @@ const char doc[] = "zheng - Simulates pedestrian evacuation using the Zheng (201
 #define OPT_OMEGA 1018
 #define OPT_MU 1019
 #define OPT_FIRE_SPREAD_RATE 1020
+#define OPT_WORKERS 1021
+#define OPT_HEATMAP_WINDOW 1022
+#define OPT_SWEEP_FILE 1023
+#define OPT_SAVE_CHECKPOINT 1024
+#define OPT_CHECKPOINT_TIMESTEP 1025
+#define OPT_LOAD_CHECKPOINT 1026
+#define OPT_CONVERGENCE 1027
+#define OPT_MIN_SIMULATIONS 1028
+#define OPT_RUN_STATISTICS 1029
+#define OPT_PROFILE 1030
+#define OPT_WEIGHT_CACHE 1031
+#define OPT_DOOR_COMBINATIONS 1032
+#define OPT_COMBINATION_RULE 1033
 #define OPT_MIN_SIMULATION_VALUE 2000
 #define OPT_MAX_SIMULATION_VALUE 2001
 #define OPT_STEP_VALUE 2002
@@ -78,10 +97,17 @@ struct argp_option options[] = {
     {"env-file", 'e', "ENV-FILE", 0, "Name of the file that contains environment information: dimensions and its mapped features, including obstacles, walls, and optionally, pedestrians and doors.",2},
     {"output-file", 'o', "OUTPUT-FILE", OPTION_ARG_OPTIONAL, "Specifies whether the output should be stored in a file (default is stdout), with the file name being optionally provided."},
     {"auxiliary-file", 'a', "AUXILIARY-FILE",0, "Name of the configuration file that contains the coordinates of exits for each simulation set."},
+    {"door-combinations", OPT_DOOR_COMBINATIONS, "DOORS", 0, "The auxiliary file lists candidate doors, one per line, and each simulation set combines DOORS of them, following --combination-rule. The static weights of each candidate door are calculated only once."},
+    {"combination-rule", OPT_COMBINATION_RULE, "RULE", 0, "How the candidate doors of --door-combinations are combined."},
+    {"sweep-file", OPT_SWEEP_FILE, "SWEEP-FILE", 0, "Name of the file that describes a sweep over several constants (Cartesian or Latin hypercube). Each simulation set runs every point of the sweep, instead of varying a single constant with --min, --max and --step."},
+    {"save-checkpoint", OPT_SAVE_CHECKPOINT, "CHECKPOINT-FILE", 0, "Writes the full state of the first simulation at the end of the timestep given by --checkpoint-timestep to CHECKPOINT-FILE, in the checkpoints directory."},
+    {"checkpoint-timestep", OPT_CHECKPOINT_TIMESTEP, "TIMESTEP", 0, "The timestep at which the checkpoint of --save-checkpoint is captured."},
+    {"load-checkpoint", OPT_LOAD_CHECKPOINT, "CHECKPOINT-FILE", 0, "Every simulation starts from the state stored in CHECKPOINT-FILE (in the checkpoints directory), instead of placing the pedestrians, each one being a different continuation given by its seed. The timesteps run before the checkpoint are counted."},
 
     {"\nInput/Output Configuration:\n",0,0,OPTION_DOC,0,3},    
     {"env-load-method", 'm', "METHOD",0, "How the environment will be loaded or whether it will be created.",4},
     {"output-format", 'O', "FORMAT", 0, "The type of output to be generated by the simulations."},
+    {"heatmap-window", OPT_HEATMAP_WINDOW, "TIMESTEPS", 0, "Splits the heatmap output in windows of TIMESTEPS timesteps, printing one heatmap per window instead of a single heatmap for the whole simulations. Defaults to 0 (no windows)."},
     
     {"\nEnvironment Dimensions (required for auto created environments):\n",0,0,OPTION_DOC,0,5},
     {"lin", 'l', "LINES", 0, "Number of lines for the environment when it is being created.",6},
@@ -91,6 +117,10 @@ struct argp_option options[] = {
     {"simu", 's', "SIMULATIONS", 0, "Number of simulations for each simulation set (default is 1).",8},
     {"seed", OPT_SEED, "SEED", 0, "Initial seed for the srand function (default is 0). If a negative number is given, the starting seed will be set to the value returned by time()."},
     {"diagonal", OPT_DIAGONAL, "DIAGONAL", 0, "The diagonal value for calculation of the static floor field (default is 1.5)."},
+    {"convergence", OPT_CONVERGENCE, "TOLERANCE", 0, "Stops running the simulations of a point (a value of the varying constant, or a point of the sweep file) once the half-width of the 95% confidence interval of the mean number of timesteps is below TOLERANCE times the mean. --simu becomes the maximum number of simulations, and the number actually used is written before the results. Defaults to 0 (disabled)."},
+    {"min-simulations", OPT_MIN_SIMULATIONS, "SIMULATIONS", 0, "Minimum number of simulations of a point before --convergence is tested (default is 10)."},
+    {"weight-cache", OPT_WEIGHT_CACHE, 0, 0, "Stores the static weights of every exit in the cache directory, in a file named after a hash of the environment structure, the exit cells, --diagonal and --avoid-corner-movement, and reuses them whenever the same exit is simulated again, in this or in a later run."},
+    {"workers", OPT_WORKERS, "WORKERS", 0, "Number of worker processes among which the simulations are divided (default is 1). With an auxiliary file and the timesteps output format, the simulations of every simulation set are divided at once, and the results are still written in order. Ignored for the visual output format and with --debug."},
 
     {"\nVariables and toggle options related to pedestrians (all optional):\n",0,0,OPTION_DOC,0,9},
     {"ped", 'p', "PEDESTRIANS", 0, "Manually set the number of pedestrians to be randomly placed in the environment. If provided takes precedence over --density.",10},
@@ -111,7 +141,7 @@ struct argp_option options[] = {
     {"fire-gamma", OPT_FIRE_GAMMA, "FIRE_GAMMA", 0, "A constant used in the calculation of the fire floor field. If the distance from a cell to a cell with fire is greater than FIRE_GAMMA, the fire floor field (FF) value of that cell will be 0. Otherwise, the value will be equal to or greater than 0. The default value of FIRE_GAMMA is 8."},
     {"omega", OPT_OMEGA, "OMEGA", 0, "In the Zheng paper, pedestrians try to maintain their preferred direction and velocity. The constant Omega increases the probability that a pedestrian will move to cells aligned with their preferred direction. Must be a value greater or equal to 1. Defaults to 1."},
     {"mu", OPT_MU, "MU", 0, "The probability that, in a conflict where multiple pedestrians attempt to move to the same cell, no one will successfully move. Value must be between 0 and 1, both inclusive. Defaults to 0.1."},
-    {"spread-rate", OPT_FIRE_SPREAD_RATE, "RATE", 0, "The velocity, in meters per second, that the fire spreads in the environment. Defaults to 0.1 m/s."},
+    {"spread-rate", OPT_FIRE_SPREAD_RATE, "RATE", 0, "The velocity, in meters per second, that the fire spreads in the environment. Must be positive and at most 1.5 m/s, so the fire spreads at most once per timestep. Defaults to 0.1 m/s."},
     
     {"\nRange values for simulation focused on a constant:\n",0,0,OPTION_DOC,0, 15},
     {"min", OPT_MIN_SIMULATION_VALUE, "MIN", 0, "The minimum value that the variable constant will assume. Defaults to 0.", 16},
@@ -122,6 +152,8 @@ struct argp_option options[] = {
     {"debug", OPT_DEBUG, 0,0 , "Prints debug information to stdout.",18},
     {"simulation-set-info", OPT_SIMULATION_SET_INFO, 0, 0, "Prints simulation set information (exits coordinates) to the output file."},
     {"single-exit-flag", OPT_SINGLE_EXIT_FLAG, 0,0, "Prints a flag (#1) before the results for every simulation set that has only one exit."},
+    {"profile", OPT_PROFILE, "CSV-FILE", OPTION_ARG_OPTIONAL, "Times each phase of the timestep loop (vision, transition probabilities, conflicts, movement, grid update, diffusion, fire propagation and static field), printing a summary table to stderr after each simulation set. The raw counts are written to CSV-FILE (profile.csv by default), in the output directory."},
+    {"run-statistics", OPT_RUN_STATISTICS, 0,0, "Prints to stderr, at the end of the program, the number of simulations, timesteps and pedestrian-steps (the pedestrians in the environment, summed over every timestep) that were run."},
 
     {"\nAdditional Information:\n",0,0,OPTION_DOC,0,19},
     {0}
@@ -134,15 +166,23 @@ Command_Line_Args cli_args = {
     .environment_filename="varas_queue.txt",
     .output_filename="",
     .auxiliary_filename="",
+    .sweep_filename="",
+    .save_checkpoint_filename="",
+    .load_checkpoint_filename="",
+    .profile_filename="profile.csv",
     .output_format = OUTPUT_VISUALIZATION,
     .environment_origin = STRUCTURE_DOORS_AND_PEDESTRIANS,
     .simulation_type = SIMULATION_DOOR_LOCATION_ONLY,
+    .combination_rule = COMBINATION_UNORDERED,
     .write_to_file=false,
     .show_debug_information=false,
     .show_simulation_set_info=false,
     .immediate_exit=false,
     .prevent_corner_crossing=false,
     .single_exit_flag = false,
+    .print_run_statistics = false,
+    .profile = false,
+    .use_weight_cache = false,
     .use_density = true,
     .fire_is_present = false,
     .global_line_number = 0,
@@ -150,6 +190,11 @@ Command_Line_Args cli_args = {
     .num_simulations = 1, // A single simulation by default.
     .total_num_pedestrians = 0,
     .seed = 0,
+    .num_workers = 1,
+    .heatmap_window = 0,
+    .min_simulations = 10,
+    .checkpoint_timestep = 0,
+    .door_combination_size = 0,
     .diagonal = 1.5,
     .alpha=0.5,
     .fire_alpha=0.5,
@@ -165,7 +210,8 @@ Command_Line_Args cli_args = {
     .min=0,
     .max=1,
     .step=0.01,
-    .spread_rate=0.1
+    .spread_rate=0.1,
+    .convergence_tolerance=0
 };
 // When loading an environment global_line_number and global_column_number will no be obtained from the command line arguments. Besides, total_num_pedestrians will be automatic determined by the program on some environment origin formats.
 
@@ -223,6 +269,39 @@ error_t parser_function(int key, char *arg, struct argp_state *state)
         case 'a':
             strcpy(cli_args->auxiliary_filename, arg);
             break;
+        case OPT_SWEEP_FILE:
+            strcpy(cli_args->sweep_filename, arg);
+            break;
+        case OPT_SAVE_CHECKPOINT:
+            strcpy(cli_args->save_checkpoint_filename, arg);
+            break;
+        case OPT_LOAD_CHECKPOINT:
+            strcpy(cli_args->load_checkpoint_filename, arg);
+            break;
+        case OPT_CONVERGENCE:
+            cli_args->convergence_tolerance = atof(arg);
+            if(cli_args->convergence_tolerance <= 0)
+            {
+                fprintf(stderr, "The convergence tolerance must be a positive number.\n");
+                return EIO;
+            }
+            break;
+        case OPT_MIN_SIMULATIONS:
+            cli_args->min_simulations = atoi(arg);
+            if(cli_args->min_simulations < 2)
+            {
+                fprintf(stderr, "The minimum number of simulations must be at least 2.\n");
+                return EIO;
+            }
+            break;
+        case OPT_CHECKPOINT_TIMESTEP:
+            cli_args->checkpoint_timestep = atoi(arg);
+            if(cli_args->checkpoint_timestep <= 0)
+            {
+                fprintf(stderr, "The checkpoint timestep must be positive.\n");
+                return EIO;
+            }
+            break;
         case 'l':
             cli_args->global_line_number = atoi(arg);
             if(cli_args->global_line_number <= 0)
@@ -277,6 +356,22 @@ error_t parser_function(int key, char *arg, struct argp_state *state)
             if(cli_args->seed < 0)
                 cli_args->seed = time(NULL);
                 
+            break;
+        case OPT_WORKERS:
+            cli_args->num_workers = atoi(arg);
+            if(cli_args->num_workers <= 0)
+            {
+                fprintf(stderr, "The number of workers must be positive.\n");
+                return EIO;
+            }
+            break;
+        case OPT_HEATMAP_WINDOW:
+            cli_args->heatmap_window = atoi(arg);
+            if(cli_args->heatmap_window < 0)
+            {
+                fprintf(stderr, "The heatmap window must be a non-negative number of timesteps.\n");
+                return EIO;
+            }
             break;
         case OPT_DEBUG:
             cli_args->show_debug_information = true;
@@ -293,6 +388,35 @@ error_t parser_function(int key, char *arg, struct argp_state *state)
         case OPT_SINGLE_EXIT_FLAG:
             cli_args->single_exit_flag = true;
             break;
+        case OPT_RUN_STATISTICS:
+            cli_args->print_run_statistics = true;
+            break;
+        case OPT_PROFILE:
+            if(arg != NULL)
+                strcpy(cli_args->profile_filename, arg);
+
+            cli_args->profile = true;
+            break;
+        case OPT_WEIGHT_CACHE:
+            cli_args->use_weight_cache = true;
+            break;
+        case OPT_DOOR_COMBINATIONS:
+            cli_args->door_combination_size = atoi(arg);
+            if(cli_args->door_combination_size <= 0)
+            {
+                fprintf(stderr, "The number of doors in each combination must be positive.\n");
+                return EIO;
+            }
+            break;
+        case OPT_COMBINATION_RULE:
+            int combination_rule = atoi(arg);
+            if(combination_rule < COMBINATION_UNORDERED || combination_rule > COMBINATION_PRODUCT)
+            {
+                fprintf(stderr, "Invalid combination rule.\n");
+                return EIO;
+            }
+            cli_args->combination_rule = (enum Combination_Rule) combination_rule;
+            break;
         case OPT_PEDESTRIAN_DENSITY:
             cli_args->density = atof(arg);
             if(cli_args->density < 0 || cli_args->density > 1)
@@ -438,9 +562,9 @@ error_t parser_function(int key, char *arg, struct argp_state *state)
             break;
         case OPT_FIRE_SPREAD_RATE:
             cli_args->spread_rate = atof(arg);
-            if(cli_args->spread_rate < 0)
+            if(cli_args->spread_rate < MIN_SPREAD_RATE || cli_args->spread_rate > MAX_SPREAD_RATE)
             {   
-                fprintf(stderr, "The spread rate value must be a non-negative number.\n");
+                fprintf(stderr, "The spread rate value must be a positive number not greater than %.1f m/s.\n", MAX_SPREAD_RATE);
                 return EIO;
             }
             break;
@@ -472,6 +596,18 @@ error_t parser_function(int key, char *arg, struct argp_state *state)
                 }
             }
 
+            if(cli_args->door_combination_size > 0 && origin_uses_auxiliary_data() == false)
+            {
+                fprintf(stderr, "--door-combinations requires --env-load-method 1, 3 or 5.\n");
+                return EIO;
+            }
+
+            if(strcmp(cli_args->save_checkpoint_filename, "") != 0 && cli_args->checkpoint_timestep == 0)
+            {
+                fprintf(stderr, "--save-checkpoint requires the --checkpoint-timestep option.\n");
+                return EIO;
+            }
+
             if(cli_args->min > cli_args->max)
             {
                 fprintf(stderr, "The value provided to the --min option must be lower than the value provided to the --max option.\n");
@@ -528,12 +664,54 @@ void extract_full_command(char *full_command, int key, char *arg)
         case OPT_SINGLE_EXIT_FLAG:
             sprintf(aux, " --single-exit-flag");
             break;
+        case OPT_RUN_STATISTICS:
+            sprintf(aux, " --run-statistics");
+            break;
+        case OPT_PROFILE:
+            if(arg == NULL)
+                sprintf(aux, " --profile");
+            else
+                sprintf(aux, " --profile=%s", arg);
+            break;
+        case OPT_WEIGHT_CACHE:
+            sprintf(aux, " --weight-cache");
+            break;
+        case OPT_DOOR_COMBINATIONS:
+            sprintf(aux, " --door-combinations=%s", arg);
+            break;
+        case OPT_COMBINATION_RULE:
+            sprintf(aux, " --combination-rule=%s", arg);
+            break;
         case OPT_SEED:
             sprintf(aux, " --seed=%s", arg);
             break;
         case OPT_DIAGONAL:
             sprintf(aux, " --diagonal=%s", arg);
             break;
+        case OPT_WORKERS:
+            sprintf(aux, " --workers=%s", arg);
+            break;
+        case OPT_HEATMAP_WINDOW:
+            sprintf(aux, " --heatmap-window=%s", arg);
+            break;
+        case OPT_SWEEP_FILE:
+            sprintf(aux, " --sweep-file=%s", arg);
+            break;
+        case OPT_SAVE_CHECKPOINT:
+            sprintf(aux, " --save-checkpoint=%s", arg);
+            break;
+        case OPT_CONVERGENCE:
+            sprintf(aux, " --convergence=%s", arg);
+            break;
+        case OPT_MIN_SIMULATIONS:
+            sprintf(aux, " --min-simulations=%s", arg);
+            break;
+        case OPT_CHECKPOINT_TIMESTEP:
+            sprintf(aux, " --checkpoint-timestep=%s", arg);
+            break;
+        case OPT_LOAD_CHECKPOINT:
+            sprintf(aux, " --load-checkpoint=%s", arg);
+            break;
         case OPT_PEDESTRIAN_DENSITY:
             sprintf(aux, " --density=%s", arg);
             break;
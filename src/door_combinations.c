@@ -0,0 +1,318 @@
+/*
+   File: door_combinations.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the door-combination mode (enabled with --door-combinations). The auxiliary file lists candidate doors, one per line, and every simulation set uses a combination of them, generated according to --combination-rule. The static weights and the distance grid of each candidate door are calculated once; each simulation set then reuses the same exits, and its static field is composed from their distance grids (see compose_zheng_static_field).
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<limits.h>
+
+#include"../headers/door_combinations.h"
+#include"../headers/exit.h"
+#include"../headers/static_field.h"
+#include"../headers/initialization.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+static Function_Status place_door_tuple(int *exit_number);
+static bool advance_door_tuple();
+static bool is_door_tuple_valid();
+
+static Exit *candidate_doors = NULL;
+static bool *is_door_accessible = NULL;
+static int num_candidate_doors = 0;
+
+static int *door_tuple = NULL; // Indices of the candidate doors of the current simulation set, with cli_args.door_combination_size positions.
+static bool has_tuple_started = false;
+static int tuple_index = -1; // Index of the combination in door_tuple, counting only the valid tuples.
+static bool is_combination_accessible = true;
+
+/**
+ * Reads the candidate doors from the auxiliary file (one door per line, in the syntax of the auxiliary files) and calculates,
+ * once, the static weights and the distance grid of each one.
+ *
+ * @param auxiliary_file File where the candidate doors are stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status load_candidate_doors(FILE *auxiliary_file)
+{
+    int exit_number = 0;
+
+    do
+    {
+        if(get_next_simulation_set(auxiliary_file, &exit_number) == FAILURE)
+            return FAILURE;
+
+        if(exit_number > 1)
+        {
+            fprintf(stderr, "Each line of the auxiliary file must hold a single candidate door when --door-combinations is used.\n");
+            return FAILURE;
+        }
+    }while(exit_number == 1);
+
+    // The doors read are owned by this module. Each simulation set places some of them in the exits set.
+    candidate_doors = exits_set.list;
+    num_candidate_doors = exits_set.num_exits;
+    exits_set.list = NULL;
+    exits_set.num_exits = 0;
+
+    if(num_candidate_doors < cli_args.door_combination_size)
+    {
+        fprintf(stderr, "The auxiliary file has %d candidate doors, less than the %d doors of each combination.\n", num_candidate_doors, cli_args.door_combination_size);
+        return FAILURE;
+    }
+
+    is_door_accessible = malloc(sizeof(bool) * num_candidate_doors);
+    door_tuple = malloc(sizeof(int) * cli_args.door_combination_size);
+    if(is_door_accessible == NULL || door_tuple == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the door combination lists.\n");
+        return FAILURE;
+    }
+
+    for(int door_index = 0; door_index < num_candidate_doors; door_index++)
+    {
+        Function_Status returned_status = calculate_static_weight(candidate_doors[door_index]);
+        if(returned_status == FAILURE)
+            return FAILURE;
+
+        is_door_accessible[door_index] = returned_status != INACCESSIBLE_EXIT;
+        calculate_exit_distance_grid(candidate_doors[door_index]);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Counts the simulation sets of the door-combination mode.
+ *
+ * @return The number of door combinations, or -1 if there are too many.
+ */
+int count_door_combinations()
+{
+    int count = 0;
+
+    has_tuple_started = false;
+    tuple_index = -1;
+    while(advance_door_tuple())
+    {
+        if(count == INT_MAX)
+        {
+            fprintf(stderr, "There are too many door combinations.\n");
+            return -1;
+        }
+
+        count++;
+    }
+    has_tuple_started = false;
+    tuple_index = -1;
+
+    return count;
+}
+
+/**
+ * Places the doors of the next combination in the exits set, as get_next_simulation_set does for an auxiliary file.
+ *
+ * @note A door repeated in a combination (only possible with the product rule) is used once, so combining a door with itself gives a single-exit simulation set.
+ *
+ * @param exit_number Pointer to an integer, where the number of exits of the simulation set will be stored (0 after the last combination).
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status get_next_door_combination(int *exit_number)
+{
+    *exit_number = 0;
+
+    if(! advance_door_tuple())
+        return SUCCESS; // All combinations were processed.
+
+    return place_door_tuple(exit_number);
+}
+
+/**
+ * Places the doors of the given combination in the exits set, so the simulation sets may be visited in any order.
+ *
+ * @note The combinations are generated in order, so visiting them in increasing order is the fastest.
+ *
+ * @param combination_index Index of the combination (the index of its simulation set).
+ * @param exit_number Pointer to an integer, where the number of exits of the simulation set will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status get_door_combination(int combination_index, int *exit_number)
+{
+    *exit_number = 0;
+
+    if(combination_index < tuple_index)
+    {
+        has_tuple_started = false;
+        tuple_index = -1;
+    }
+
+    while(tuple_index < combination_index)
+    {
+        if(! advance_door_tuple())
+        {
+            fprintf(stderr, "There is no door combination with index %d.\n", combination_index);
+            return FAILURE;
+        }
+    }
+
+    return place_door_tuple(exit_number);
+}
+
+/**
+ * Replaces calculate_all_static_weights for a door combination, whose static weights were calculated when the doors were loaded.
+ *
+ * @return Function_Status: SUCCESS (1) or INACCESSIBLE_EXIT (2).
+ */
+Function_Status check_door_combination_accessibility()
+{
+    return is_combination_accessible ? SUCCESS : INACCESSIBLE_EXIT;
+}
+
+/**
+ * Removes the doors of the current combination from the exits set, without deallocating them, and deallocates the exits set fields.
+ */
+void release_door_combination()
+{
+    detach_door_combination();
+    deallocate_exits_set_fields();
+}
+
+/**
+ * Removes the doors of the current combination from the exits set, without deallocating them. The exits set fields are kept,
+ * so they may be reused by the next combination.
+ */
+void detach_door_combination()
+{
+    free(exits_set.list);
+    exits_set.list = NULL;
+    exits_set.num_exits = 0;
+}
+
+/**
+ * Deallocates the candidate doors and the combination lists.
+ */
+void deallocate_door_combinations()
+{
+    release_door_combination();
+
+    exits_set.list = candidate_doors;
+    exits_set.num_exits = num_candidate_doors;
+    deallocate_exits();
+
+    free(is_door_accessible);
+    free(door_tuple);
+    candidate_doors = NULL;
+    is_door_accessible = NULL;
+    door_tuple = NULL;
+    num_candidate_doors = 0;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Places the doors of door_tuple in the exits set, marking their cells in the cell_state_grid.
+ *
+ * @note A door repeated in the tuple (only possible with the product rule) is used once.
+ *
+ * @param exit_number Pointer to an integer, where the number of exits of the simulation set will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status place_door_tuple(int *exit_number)
+{
+    clear_cell_state_flags(cell_state_grid, ANY_EXIT_STATE);
+
+    exits_set.list = malloc(sizeof(Exit) * cli_args.door_combination_size);
+    if(exits_set.list == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the exits list of a door combination.\n");
+        return FAILURE;
+    }
+
+    is_combination_accessible = true;
+    for(int position = 0; position < cli_args.door_combination_size; position++)
+    {
+        bool is_repeated = false;
+        for(int previous = 0; previous < position; previous++)
+            is_repeated = is_repeated || door_tuple[previous] == door_tuple[position];
+
+        if(is_repeated)
+            continue;
+
+        Exit door = candidate_doors[door_tuple[position]];
+        exits_set.list[exits_set.num_exits++] = door;
+        is_combination_accessible = is_combination_accessible && is_door_accessible[door_tuple[position]];
+
+        for(int cell_index = 0; cell_index < door->width; cell_index++)
+            cell_state_grid[door->coordinates[cell_index].lin][door->coordinates[cell_index].col] |= EXIT_STATE;
+    }
+
+    *exit_number = exits_set.num_exits;
+
+    return SUCCESS;
+}
+
+/**
+ * Moves door_tuple to the next tuple, in lexicographic order, that is valid for the combination rule.
+ *
+ * @return bool, where True indicates that a tuple was found, or False when every tuple was visited.
+ */
+static bool advance_door_tuple()
+{
+    int size = cli_args.door_combination_size;
+
+    do
+    {
+        if(! has_tuple_started)
+        {
+            for(int position = 0; position < size; position++)
+                door_tuple[position] = 0;
+
+            has_tuple_started = true;
+        }
+        else
+        {
+            int position = size - 1;
+            while(position >= 0 && door_tuple[position] == num_candidate_doors - 1)
+                door_tuple[position--] = 0;
+
+            if(position < 0)
+                return false;
+
+            door_tuple[position]++;
+        }
+    }while(! is_door_tuple_valid());
+
+    tuple_index++;
+
+    return true;
+}
+
+/**
+ * Verifies if door_tuple follows the combination rule: strictly increasing indices for combinations, distinct indices for
+ * permutations and any indices for the product.
+ *
+ * @return bool, where True indicates that the tuple is valid, or False otherwise.
+ */
+static bool is_door_tuple_valid()
+{
+    int size = cli_args.door_combination_size;
+
+    for(int position = 0; position < size; position++)
+    {
+        for(int previous = 0; previous < position; previous++)
+        {
+            if(cli_args.combination_rule == COMBINATION_UNORDERED && door_tuple[previous] >= door_tuple[position])
+                return false;
+
+            if(cli_args.combination_rule == COMBINATION_ORDERED && door_tuple[previous] == door_tuple[position])
+                return false;
+        }
+    }
+
+    return true;
+}
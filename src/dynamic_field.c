@@ -12,10 +12,11 @@
 #include"../headers/exit.h"
 #include"../headers/grid.h"
 #include"../headers/pedestrian.h"
+#include"../headers/cell_graph.h"
 #include"../headers/cli_processing.h"
 #include"../headers/shared_resources.h"
 
-static void normalize_dynamic_field_values(Double_Grid to_be_normalized, double total_sum);
+static void normalize_dynamic_field_values(Field_Grid to_be_normalized, double total_sum);
 
 /**
  * Increases the cell at the given coordinates in one particle.
@@ -30,46 +31,49 @@ void increase_particle_at(Location coordinates)
 /**
  * Evaluates the decay and diffusion for all cells in the dynamic floor field, normalizing them after the process is completed.
  * 
+ * @note Only the cells of the walkable graph (where the static field isn't IMPASSABLE_OBJECT) hold particles, and diffusion doesn't occur in the diagonals.
+ * 
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
  */
 Function_Status apply_decay_and_diffusion()
 {
-    static Location modifiers[] = {{-1,0}, {0,-1}, {0,1}, {1,0}}; // Diffusion doesn't occur in the diagonals.
-
-    if( fill_double_grid(exits_set.aux_dynamic_grid, cli_args.global_line_number, cli_args.global_column_number, 0) == FAILURE)
+    if( fill_field_grid(exits_set.aux_dynamic_grid, cli_args.global_line_number, cli_args.global_column_number, 0) == FAILURE)
         return FAILURE;
 
+    Field_Value *dynamic_field = exits_set.dynamic_floor_field[0];
+    Field_Value *aux_dynamic_field = exits_set.aux_dynamic_grid[0];
+
+    // The coefficients of the decay and diffusion, in the precision of the grids (see Field_Value).
+    Field_Value remaining_fraction = (1 - cli_args.alpha) * (1 - cli_args.delta);
+    Field_Value neighbor_fraction = cli_args.alpha * ((1 - cli_args.delta) / 4);
+
     double total_sum = 0;
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
     {
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            if(exits_set.static_floor_field[i][j] == IMPASSABLE_OBJECT || is_cell_with_fire((Location) {i,j}))
-                continue;
-
-            exits_set.aux_dynamic_grid[i][j] = (1 - cli_args.alpha) * (1 - cli_args.delta) * exits_set.dynamic_floor_field[i][j];
+        if(is_cell_with_fire(walkable_graph.cells[cell_index]))
+            continue;
 
-            double neighbor_sum = 0;
-            for(int m = 0; m < 4; m++)
-            {
-                if(! is_within_grid_lines(i + modifiers[m].lin) || ! is_within_grid_columns(j + modifiers[m].col))
-                    continue;
+        int offset = walkable_graph.offsets[cell_index];
+        aux_dynamic_field[offset] = remaining_fraction * dynamic_field[offset];
 
-                if(exits_set.static_floor_field[i + modifiers[m].lin][j + modifiers[m].col] == IMPASSABLE_OBJECT || 
-                    is_cell_with_fire((Location) {i + modifiers[m].lin, j + modifiers[m].col}))
-                    continue;
+        Field_Value neighbor_sum = 0;
+        for(int m = 0; m < 4; m++)
+        {
+            int neighbor = walkable_graph.von_neumann_neighbors[4 * cell_index + m];
 
-                neighbor_sum += exits_set.dynamic_floor_field[i + modifiers[m].lin][j + modifiers[m].col];
-            }
+            if(neighbor == NO_NEIGHBOR || is_cell_with_fire(walkable_graph.cells[neighbor]))
+                continue;
 
-            exits_set.aux_dynamic_grid[i][j] += cli_args.alpha * ((1 - cli_args.delta) / 4) * neighbor_sum;
-            total_sum += exits_set.aux_dynamic_grid[i][j];
+            neighbor_sum += dynamic_field[walkable_graph.offsets[neighbor]];
         }
+
+        aux_dynamic_field[offset] += neighbor_fraction * neighbor_sum;
+        total_sum += aux_dynamic_field[offset];
     }
 
     normalize_dynamic_field_values(exits_set.aux_dynamic_grid, total_sum);
 
-    if( copy_double_grid(exits_set.dynamic_floor_field, exits_set.aux_dynamic_grid) == FAILURE)
+    if( copy_field_grid(exits_set.dynamic_floor_field, exits_set.aux_dynamic_grid) == FAILURE)
         return FAILURE;
 
     return SUCCESS;
@@ -80,23 +84,19 @@ Function_Status apply_decay_and_diffusion()
 /* ---------------- ---------------- ---------------- ---------------- ---------------- */
 
 /**
- * Normalizes all values of the given Double_grid. The normalization for each position is the position value divided by the total_sum provided.
+ * Normalizes all values of the given Field_Grid. The normalization for each position is the position value divided by the total_sum provided.
  * 
- * @param to_be_normalized Double grid whose values will be normalized
+ * @param to_be_normalized Field grid whose values will be normalized. Only the cells of the walkable graph may hold values other than 0.
  * @param total_sum The sum of all values in the provided grid.
  * 
  * @note If total_sum is equal to 0, nothing is done.
  */
-static void normalize_dynamic_field_values(Double_Grid to_be_normalized, double total_sum)
+static void normalize_dynamic_field_values(Field_Grid to_be_normalized, double total_sum)
 {
     if(total_sum == 0)
         return;
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
-    {
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            to_be_normalized[i][j] /= total_sum;
-        }
-    }
+    Field_Value normalizer = total_sum;
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
+        to_be_normalized[0][walkable_graph.offsets[cell_index]] /= normalizer;
 }
@@ -19,9 +19,6 @@
 
 Location non_diagonal_modifiers[4] = {{-1, 0}, {0, -1}, {0, 1} , {1, 0}}; // The modifiers for the neighbor cells not in the diagonals.
 
-Int_Grid exits_only_grid = NULL; // Grid containing only the exits.
-                                 // Contains cells with either EXIT_CELL or EMPTY_CELL values.
-
 Exits_Set exits_set = {NULL, NULL, NULL, NULL, 0, NULL, NULL, NULL};
 
 static Exit create_new_exit(Location exit_coordinates);
@@ -111,12 +108,12 @@ Function_Status set_private_grid_data(Exit current_exit)
 */
 Function_Status allocate_exits_set_fields()
 {
-    exits_set.static_floor_field = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_set.dynamic_floor_field = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_set.fire_floor_field = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_set.aux_static_grid = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_set.aux_dynamic_grid = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_set.distance_to_exits_grid = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.static_floor_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.dynamic_floor_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.fire_floor_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.aux_static_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.aux_dynamic_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    exits_set.distance_to_exits_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
     if(exits_set.static_floor_field == NULL || exits_set.dynamic_floor_field == NULL || 
        exits_set.fire_floor_field == NULL || exits_set.aux_static_grid == NULL ||
        exits_set.aux_dynamic_grid == NULL || exits_set.distance_to_exits_grid == NULL)
@@ -132,6 +129,15 @@ Function_Status allocate_exits_set_fields()
  * Deallocate and reset the structures related to each exit and the exists set.
 */
 void deallocate_exits()
+{
+    deallocate_exits_list();
+    deallocate_exits_set_fields();
+}
+
+/**
+ * Deallocates the exits of the exits set, keeping the exits set grids, so they may be reused by another simulation set.
+ */
+void deallocate_exits_list()
 {
     for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
     {
@@ -140,12 +146,20 @@ void deallocate_exits()
         free(current->coordinates);
         deallocate_grid((void **) current->private_structure_grid, cli_args.global_line_number);
         deallocate_grid((void **) current->varas_static_weight, cli_args.global_line_number);
+        deallocate_grid((void **) current->nearest_distance_grid, cli_args.global_line_number);
         free(current);
     }
 
     free(exits_set.list);
     exits_set.list = NULL;
+    exits_set.num_exits = 0;
+}
 
+/**
+ * Deallocates the grids allocated by allocate_exits_set_fields.
+ */
+void deallocate_exits_set_fields()
+{
     deallocate_grid((void **) exits_set.static_floor_field, cli_args.global_line_number);
     deallocate_grid((void **) exits_set.dynamic_floor_field, cli_args.global_line_number);
     deallocate_grid((void **) exits_set.fire_floor_field, cli_args.global_line_number);
@@ -158,8 +172,6 @@ void deallocate_exits()
     exits_set.aux_static_grid = NULL;
     exits_set.aux_dynamic_grid = NULL;
     exits_set.distance_to_exits_grid = NULL;
-
-    exits_set.num_exits = 0;
 }
 
 /**
@@ -178,92 +190,119 @@ void check_for_exits_blocked_by_fire()
             continue;
 
         if(is_exit_blocked_by_fire(current_exit))
+            mark_exit_as_blocked(current_exit);
+    }
+}
+
+/**
+ * Marks the given exit as blocked by fire, setting its flag and replacing the EXIT_STATE of its cells in the cell_state_grid by BLOCKED_EXIT_STATE.
+ * 
+ * @param current_exit The exit that will be marked.
+ */
+void mark_exit_as_blocked(Exit current_exit)
+{
+    current_exit->is_blocked_by_fire = true;
+
+    for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
+    {
+        Location curr = current_exit->coordinates[cell_index];
+        cell_state_grid[curr.lin][curr.col] = (cell_state_grid[curr.lin][curr.col] & ~EXIT_STATE) | BLOCKED_EXIT_STATE;
+    }
+}
+
+/**
+ * Computes the distance from each cell to the nearest cell of the given exit, storing it in the exit's nearest_distance_grid.
+ * 
+ * @note The distances depend only on the exit cells, so they are computed once per simulation set (see calculate_all_static_weights).
+ * 
+ * @param current_exit The exit whose distances will be computed.
+ */
+void calculate_exit_distance_grid(Exit current_exit)
+{
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
         {
-            current_exit->is_blocked_by_fire = true;
+            double nearest_distance = -1;
 
-            for(int cell_index; cell_index < current_exit->width; cell_index++)
+            for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
             {
-                Location curr = current_exit->coordinates[cell_index];
-                exits_only_grid[curr.lin][curr.col] = BLOCKED_EXIT_CELL;
+                double distance_to_exit = euclidean_distance(current_exit->coordinates[cell_index], (Location) {i,j});
+
+                if(nearest_distance == -1 || distance_to_exit < nearest_distance)
+                    nearest_distance = distance_to_exit;
             }
+
+            current_exit->nearest_distance_grid[i][j] = nearest_distance;
         }
     }
 }
 
 /**
- * Extracts the coordinates of the non-blocked exits.
+ * Returns the distance from the given cell to the nearest cell of the exits not blocked by fire, as the minimum of their nearest_distance_grid.
  * 
- * @param num_exit_cells A pointer to a integer, where the number of exit cells in the returned array will be stored.
- * @return A pointer to an array of Locations, holding the coordinates of the non-blocked exit cells.
+ * @param line Line of the cell.
+ * @param column Column of the cell.
+ * @return The distance, or -1 if every exit is blocked.
  */
-Location *extract_non_blocked_exit_coordinates(int *num_exit_cells)
+double distance_to_closest_non_blocked_exit(int line, int column)
 {
-    Location *exit_cell_coordinates = NULL;
-    *num_exit_cells = 0;
+    double nearest_distance = -1;
 
-    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++) 
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
     {
         Exit current_exit = exits_set.list[exit_index];
 
         if(current_exit->is_blocked_by_fire)
             continue;
 
-        for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
-        {
-            Location current_cell = current_exit->coordinates[cell_index];
-            
-            exit_cell_coordinates = realloc(exit_cell_coordinates, sizeof(Location) * (*num_exit_cells + 1));
-            if(exit_cell_coordinates == NULL)
-            {
-                fprintf(stderr, "Failure in the realloc of the exit_cells_coordinates list (extract_non_blocked).\n");
-                return NULL;
-            }
-
-            exit_cell_coordinates[*num_exit_cells] = current_cell;
-            (*num_exit_cells)++;
-        }
+        double distance_to_exit = current_exit->nearest_distance_grid[line][column];
+        if(nearest_distance == -1 || distance_to_exit < nearest_distance)
+            nearest_distance = distance_to_exit;
     }
 
-    return exit_cell_coordinates;
+    return nearest_distance;
 }
 
 /**
- * Computes the distance from each cell to the nearest exit cell, storing the information in the distance_to_exits_grid.
- * 
- * @param exit_cell_coordinates A list of all the valid exit cells.
- * @param num_exit_cells The number of exit cells.
+ * Computes the distance from each cell to the nearest non-blocked exit, storing the information in the distance_to_exits_grid.
+ * The distance is composed from the nearest_distance_grid of each exit, so its cost grows with the number of exits instead of exit cells.
  */
-void calculate_distance_to_closest_exit(Location *exit_cell_coordinates, int num_exit_cells)
+void compose_distance_to_closest_exit()
 {
-    fill_double_grid(exits_set.distance_to_exits_grid, cli_args.global_line_number, cli_args.global_column_number, -1);
-    
     for(int i = 0; i < cli_args.global_line_number; i++)
     {
         for(int j = 0; j < cli_args.global_column_number; j++)
         {
             if(exits_set.static_floor_field[i][j] == IMPASSABLE_OBJECT)
-                continue;
-
-            for(int cell_index = 0; cell_index < num_exit_cells; cell_index++)
-            {
-                Location current_exit_cell = exit_cell_coordinates[cell_index]; // The current exit cell being used as the reference.
-                double distance_to_exit = euclidean_distance(current_exit_cell, (Location) {i,j});
-
-                if(exits_set.distance_to_exits_grid[i][j] == -1 || distance_to_exit < exits_set.distance_to_exits_grid[i][j])
-                    exits_set.distance_to_exits_grid[i][j] = distance_to_exit;
-            }
+                exits_set.distance_to_exits_grid[i][j] = -1;
+            else
+                exits_set.distance_to_exits_grid[i][j] = distance_to_closest_non_blocked_exit(i, j);
         }
     }
 }
 
 /**
- * Resets, for all exits, the variable that indicates if a exit has been blocked to false.
+ * Resets, for all exits, the variable that indicates if a exit has been blocked to false, marking their cells in the cell_state_grid with EXIT_STATE again.
+ * 
+ * @note Restoring the cell_state_grid makes every simulation independent of the ones that ran before it in the same process.
  */
 void reset_exits()
 {
     for(int exit = 0; exit < exits_set.num_exits; exit++)
     {
-        exits_set.list[exit]->is_blocked_by_fire = false;
+        Exit current_exit = exits_set.list[exit];
+
+        if(current_exit->is_blocked_by_fire)
+        {
+            for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
+            {
+                Location curr = current_exit->coordinates[cell_index];
+                cell_state_grid[curr.lin][curr.col] = (cell_state_grid[curr.lin][curr.col] & ~BLOCKED_EXIT_STATE) | EXIT_STATE;
+            }
+        }
+
+        current_exit->is_blocked_by_fire = false;
     }
 }
 
@@ -330,8 +369,9 @@ static Exit create_new_exit(Location exit_coordinates)
             new_exit->width = 1;
             new_exit->is_blocked_by_fire = false;
 
-            new_exit->varas_static_weight = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
+            new_exit->varas_static_weight = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
             new_exit->private_structure_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
+            new_exit->nearest_distance_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
         }
 
         return new_exit;
@@ -369,7 +409,7 @@ static bool is_exit_blocked_by_fire(Exit current_exit)
                current_exit->private_structure_grid[c.lin + current_modifier.lin][c.col + current_modifier.col] == EXIT_CELL)
                 continue;
 
-            if(fire_grid[c.lin + current_modifier.lin][c.col + current_modifier.col] == EMPTY_CELL) // No fire in the specified cell
+            if(! is_cell_with_fire((Location) {c.lin + current_modifier.lin, c.col + current_modifier.col})) // No fire in the specified cell
                 return false;
         }
     }
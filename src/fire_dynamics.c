@@ -5,48 +5,223 @@
    Description: 
 */
 
+#include<stdio.h>
 #include<stdlib.h>
 
 #include"../headers/fire_dynamics.h"
 #include"../headers/grid.h"
+#include"../headers/bitboard.h"
 #include"../headers/cli_processing.h"
 #include"../headers/shared_resources.h"
 
-Location moore_modifiers[8] = {{-1,-1}, {-1,0}, {-1,1}, {0,-1}, {0,1}, {1,-1}, {1,0}, {1,1}};
+Int_Grid initial_fire_grid = NULL; // Grid holding the location of the initial fires, with either FIRE_CELL or EMPTY_CELL values. Once initialized never changes.
+Int_Grid ignition_epoch_grid = NULL; // Epoch (number of spreads) in which each cell catches fire: 0 for the initial fires and NEVER_IGNITED for the cells the fire never reaches.
+int last_ignition_epoch = 0; // Epoch in which the last cells catch fire. After it, the fire no longer changes.
+int current_fire_epoch = 0; // Number of spreads of the fire in the current simulation. The cells with fire are those whose ignition epoch isn't greater,
+                            // which have the FIRE_STATE in the cell_state_grid (see mark_fire_cells).
 
-Int_Grid fire_grid = NULL; // Grid containing only fire.
-                           // Contains cells with wither FIRE_CELL or EMPTY_CELL values
-Int_Grid initial_fire_grid = NULL; // Grid just like the fire_grid, but holds the location of the initial fires. Once initialized never changes.
+static Location *ignition_order = NULL; // Every cell the fire reaches, epoch after epoch (and line after line within each epoch).
+static int *first_ignition_index = NULL; // Index, in ignition_order, of the first cell of each epoch, with last_ignition_epoch + 2 positions in use.
 
 /**
- * Propagate the fire in the environment, in accordance with the Zheng's 2011 article.
+ * Calculates the epoch in which each cell catches fire, in accordance with the Zheng's 2011 article: at each spread, the fire reaches
+ * every empty cell in the Moore neighborhood of a cell with fire. The epochs are found one after the other, as bitboards: the cells
+ * ignited in an epoch are the dilation of those ignited in the previous one, restricted to the empty cells the fire hasn't reached
+ * (the neighbors of the older cells were reached before).
+ * 
+ * @note Must be called after the environment is loaded or generated. The cells are kept in the order they catch fire, so the
+ * cells ignited in each epoch can be listed (see find_ignited_cells).
+ * 
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
  */
-void zheng_fire_propagation()
+Function_Status calculate_ignition_epochs()
 {
-    Int_Grid aux = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    fill_integer_grid(aux, cli_args.global_line_number, cli_args.global_column_number, EMPTY_CELL);
+    deallocate_ignition_order();
+
+    int num_grid_cells = cli_args.global_line_number * cli_args.global_column_number;
+    int num_line_words = BITBOARD_WORDS(cli_args.global_column_number);
+
+    ignition_order = malloc(sizeof(Location) * num_grid_cells);
+    first_ignition_index = malloc(sizeof(int) * (num_grid_cells + 2)); // There are never more epochs than cells.
+    Bitboard unburnt_cells = allocate_bitboard(cli_args.global_line_number, cli_args.global_column_number); // Empty cells not yet reached.
+    Bitboard fire_front = allocate_bitboard(cli_args.global_line_number, cli_args.global_column_number); // Cells ignited in the last epoch.
+    Bitboard next_fire_front = allocate_bitboard(cli_args.global_line_number, cli_args.global_column_number);
+    if(ignition_order == NULL || first_ignition_index == NULL || unburnt_cells == NULL || fire_front == NULL || next_fire_front == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the structures of the ignition epochs calculation.\n");
+        deallocate_grid((void **) unburnt_cells, cli_args.global_line_number);
+        deallocate_grid((void **) fire_front, cli_args.global_line_number);
+        deallocate_grid((void **) next_fire_front, cli_args.global_line_number);
+        deallocate_ignition_order();
+        return FAILURE;
+    }
+
+    int num_ignited_cells = 0;
+    int front_first_line = cli_args.global_line_number, front_last_line = -1; // Lines of the fire front with cells.
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+        {
+            ignition_epoch_grid[i][j] = NEVER_IGNITED;
+
+            if(initial_fire_grid[i][j] == FIRE_CELL)
+            {
+                ignition_epoch_grid[i][j] = 0;
+                ignition_order[num_ignited_cells++] = (Location) {i,j};
+                set_bitboard_cell(fire_front, (Location) {i,j});
+                if(front_first_line > i)
+                    front_first_line = i;
+                front_last_line = i;
+            }
+            else if(obstacle_grid[i][j] == EMPTY_CELL)
+                set_bitboard_cell(unburnt_cells, (Location) {i,j});
+        }
+    }
+
+    last_ignition_epoch = 0;
+    first_ignition_index[0] = 0;
+    int next_first_line = front_first_line, next_last_line = front_last_line;
+    while(dilate_bitboard(next_fire_front, fire_front, unburnt_cells, &next_first_line, &next_last_line))
+    {
+        last_ignition_epoch++;
+        first_ignition_index[last_ignition_epoch] = num_ignited_cells;
+
+        int num_epoch_cells = extract_bitboard_cells(next_fire_front, next_first_line, next_last_line, &ignition_order[num_ignited_cells]);
+        for(int cell_index = num_ignited_cells; cell_index < num_ignited_cells + num_epoch_cells; cell_index++)
+            ignition_epoch_grid[ignition_order[cell_index].lin][ignition_order[cell_index].col] = last_ignition_epoch;
+        num_ignited_cells += num_epoch_cells;
+
+        // Only the lines of the new front change the unburnt cells, and only those of the old front must be zeroed for its reuse.
+        for(int w = next_first_line * num_line_words; w < (next_last_line + 1) * num_line_words; w++)
+            unburnt_cells[0][w] &= ~next_fire_front[0][w];
+        for(int w = front_first_line * num_line_words; w < (front_last_line + 1) * num_line_words; w++)
+            fire_front[0][w] = 0;
+
+        Bitboard ignited_cells = fire_front;
+        fire_front = next_fire_front;
+        next_fire_front = ignited_cells;
+        front_first_line = next_first_line;
+        front_last_line = next_last_line;
+    }
+    first_ignition_index[last_ignition_epoch + 1] = num_ignited_cells;
+
+    deallocate_grid((void **) unburnt_cells, cli_args.global_line_number);
+    deallocate_grid((void **) fire_front, cli_args.global_line_number);
+    deallocate_grid((void **) next_fire_front, cli_args.global_line_number);
+
+    return SUCCESS;
+}
+
+/**
+ * Lists the cells that catch fire in the given epoch.
+ * 
+ * @param epoch The epoch.
+ * @param num_cells Pointer to an integer, where the number of cells in the returned array will be stored.
+ * @return A pointer to the cells (owned by this module), or NULL if no cell catches fire in the epoch.
+ */
+const Location *find_ignited_cells(int epoch, int *num_cells)
+{
+    *num_cells = 0;
+
+    if(ignition_order == NULL || epoch < 0 || epoch > last_ignition_epoch)
+        return NULL;
+
+    *num_cells = first_ignition_index[epoch + 1] - first_ignition_index[epoch];
+
+    return &ignition_order[first_ignition_index[epoch]];
+}
+
+/**
+ * Marks with FIRE_STATE, in the cell_state_grid, the cells with fire in the current epoch, removing it from every other cell.
+ * 
+ * @note Must be called whenever current_fire_epoch is set to an arbitrary epoch. When the fire spreads to the next epoch, mark_ignited_cells suffices.
+ */
+void mark_fire_cells()
+{
+    clear_cell_state_flags(cell_state_grid, FIRE_STATE);
+
+    if(ignition_order == NULL)
+        return;
+
+    int last_epoch = current_fire_epoch < last_ignition_epoch ? current_fire_epoch : last_ignition_epoch;
+    for(int cell_index = 0; cell_index < first_ignition_index[last_epoch + 1]; cell_index++)
+        cell_state_grid[ignition_order[cell_index].lin][ignition_order[cell_index].col] |= FIRE_STATE;
+}
+
+/**
+ * Marks with FIRE_STATE, in the cell_state_grid, the cells that catch fire in the current epoch.
+ */
+void mark_ignited_cells()
+{
+    int num_ignited_cells = 0;
+    const Location *ignited_cells = find_ignited_cells(current_fire_epoch, &num_ignited_cells);
+
+    for(int cell_index = 0; cell_index < num_ignited_cells; cell_index++)
+        cell_state_grid[ignited_cells[cell_index].lin][ignited_cells[cell_index].col] |= FIRE_STATE;
+}
+
+/**
+ * Deallocates the order in which the cells catch fire, kept by calculate_ignition_epochs.
+ */
+void deallocate_ignition_order()
+{
+    free(ignition_order);
+    free(first_ignition_index);
+    ignition_order = NULL;
+    first_ignition_index = NULL;
+}
+
+/**
+ * Writes the fire of the current epoch as FIRE_CELL or EMPTY_CELL values, one per cell, line after line.
+ * 
+ * @param fire_cells Array with one position per cell of the environment.
+ */
+void write_fire_cells(int *fire_cells)
+{
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+            *fire_cells++ = is_cell_with_fire((Location) {i,j}) ? FIRE_CELL : EMPTY_CELL;
+    }
+}
+
+/**
+ * Finds the epoch whose fire is the one given, cell by cell, as written by write_fire_cells.
+ * 
+ * @param fire_cells Array with one position per cell of the environment.
+ * @return The first epoch with the given fire, or -1 if the fire can't be reached from the initial fire.
+ */
+int find_fire_epoch(const int *fire_cells)
+{
+    int fire_epoch = 0;
+    int num_fire_cells = 0;
 
     for(int i = 0; i < cli_args.global_line_number; i++)
     {
         for(int j = 0; j < cli_args.global_column_number; j++)
         {
-            if(! is_cell_with_fire((Location) {i,j}))
+            if(fire_cells[i * cli_args.global_column_number + j] != FIRE_CELL)
                 continue;
 
-            aux[i][j] = FIRE_CELL;
+            if(ignition_epoch_grid[i][j] == NEVER_IGNITED)
+                return -1;
 
-            for(int mm = 0; mm < 8; mm++)
-            {
-                if( ! is_within_grid_lines(i + moore_modifiers[mm].lin) || 
-                    ! is_within_grid_columns(j + moore_modifiers[mm].col) ||
-                    obstacle_grid[i + moore_modifiers[mm].lin][j + moore_modifiers[mm].col] != EMPTY_CELL)
-                    continue;
+            if(ignition_epoch_grid[i][j] > fire_epoch)
+                fire_epoch = ignition_epoch_grid[i][j];
 
-                aux[i + moore_modifiers[mm].lin][j + moore_modifiers[mm].col] = FIRE_CELL;
-            }
+            num_fire_cells++;
         }
     }
-    
-    copy_integer_grid(fire_grid, aux);
-    deallocate_grid((void **) aux, cli_args.global_line_number);
+
+    // Every cell ignited up to the epoch must be on fire.
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+        {
+            if(ignition_epoch_grid[i][j] <= fire_epoch)
+                num_fire_cells--;
+        }
+    }
+
+    return num_fire_cells == 0 ? fire_epoch : -1;
 }
\ No newline at end of file
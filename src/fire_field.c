@@ -11,10 +11,11 @@
 #include"../headers/fire_dynamics.h"
 #include"../headers/grid.h"
 #include"../headers/exit.h"
+#include"../headers/cell_graph.h"
 #include"../headers/cli_processing.h"
 #include"../headers/shared_resources.h"
 
-Double_Grid fire_distance_grid = NULL; // Grid containing the distance of every cell to the border of the fire.
+Field_Grid fire_distance_grid = NULL; // Grid containing the distance of every cell to the border of the fire.
 
 typedef struct{
     int main_coordinate; // The coordinate that is common to all coordinates in the secondary_coordinates array.
@@ -27,7 +28,6 @@ typedef struct{
     coordinate_set *sets;
 }coordinate_set_collection;
 
-static void calculate_distance_from_cells_to_fire();
 static Function_Status add_to_coordinates_collection(coordinate_set_collection *collection, Location coordinates);
 static void extract_fire_coordinate_sets(coordinate_set_collection *collection, bool line_direction);
 static void deallocate_coordinate_sets(coordinate_set_collection collection);
@@ -36,45 +36,51 @@ static Function_Status determine_adjacent_secondary_coordinates(coordinate_set *
 
 /**
  * Calculates the fire floor field in accordance with the 2011 Zheng's article specifications.
+ * 
+ * @note Only the cells of the walkable graph (empty cells and exits) are given a value.
  */
 void calculate_fire_floor_field()
 {
-    fill_double_grid(exits_set.fire_floor_field, cli_args.global_line_number, cli_args.global_column_number, 0);
+    fill_field_grid(exits_set.fire_floor_field, cli_args.global_line_number, cli_args.global_column_number, 0);
 
     calculate_distance_from_cells_to_fire();
 
     if(! cli_args.fire_is_present)
         return; // If there is no fire, the fire floor field value is set to zero for all cells. When the pedestrian probability formula is applied, the denominator will default to 1.
 
+    Field_Value *fire_distances = fire_distance_grid[0];
+    Field_Value *fire_floor_field = exits_set.fire_floor_field[0];
+
     double sum_of_all_distances = 0;
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
     {
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            if(fire_distance_grid[i][j] > cli_args.fire_gamma || fire_grid[i][j] == FIRE_CELL || (obstacle_grid[i][j] != EMPTY_CELL && exits_only_grid[i][j] == EMPTY_CELL))
-                continue; // Too far away from the fire, so the FF field value will be 0
+        int offset = walkable_graph.offsets[cell_index];
 
-            exits_set.fire_floor_field[i][j] = 1 / fire_distance_grid[i][j];
-            sum_of_all_distances += exits_set.fire_floor_field[i][j];
-        }
+        if(fire_distances[offset] > cli_args.fire_gamma || is_cell_with_fire(walkable_graph.cells[cell_index]))
+            continue; // Too far away from the fire, so the FF field value will be 0
+
+        fire_floor_field[offset] = 1 / fire_distances[offset];
+        sum_of_all_distances += fire_floor_field[offset];
     }
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    Field_Value normalizer = sum_of_all_distances;
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
     {
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            if(exits_set.fire_floor_field[i][j] != 0)
-                exits_set.fire_floor_field[i][j] /= sum_of_all_distances;
-        }
+        int offset = walkable_graph.offsets[cell_index];
+
+        if(fire_floor_field[offset] != 0)
+            fire_floor_field[offset] /= normalizer;
     }
 }
 
 /**
  * Determine all the risky cells in the environment. A risky cell is a cell between the fire and a wall.
+ * 
+ * @note The cells are marked in the cell_state_grid with RISKY_STATE or DANGER_STATE (never both).
  */
 void determine_risky_cells()
 {
-    fill_integer_grid(risky_cells_grid, cli_args.global_line_number, cli_args.global_column_number, NON_RISKY_CELLS);
+    clear_cell_state_flags(cell_state_grid, RISKY_STATE | DANGER_STATE);
 
     if(! cli_args.fire_is_present)
          return; // If there is no fire, then there is no risky or danger cells.
@@ -83,11 +89,11 @@ void determine_risky_cells()
     {
         for(int j = 0; j < cli_args.global_column_number; j++)
         {
-            if(obstacle_grid[i][j] == IMPASSABLE_OBJECT || fire_grid[i][j] == FIRE_CELL)
+            if(cell_state_grid[i][j] & (WALL_STATE | FIRE_STATE))
                continue;
             
             if(fire_distance_grid[i][j] < 1.5) // Cells in the immediate vicinity
-                risky_cells_grid[i][j] = DANGER_CELL;
+                cell_state_grid[i][j] |= DANGER_STATE;
         }
     }
 
@@ -97,7 +103,7 @@ void determine_risky_cells()
         {
             // I included exits in this rule
             // I arbitrarly use 3 to ignore the walls that are too far from the fire. The value could be smaller, but with 3 I am certain all risky cells will be marked.
-            if(obstacle_grid[i][j] == IMPASSABLE_OBJECT && fire_distance_grid[i][j] <= 3) 
+            if((cell_state_grid[i][j] & WALL_STATE) && fire_distance_grid[i][j] <= 3) 
             {
                 for(int n = 0; n < 4; n++)
                 {
@@ -107,22 +113,18 @@ void determine_risky_cells()
                     if(! is_within_grid_lines(lin) || ! is_within_grid_columns(col))
                         continue;
 
-                    if(obstacle_grid[lin][col] == IMPASSABLE_OBJECT || fire_grid[lin][col] == FIRE_CELL)
+                    if(cell_state_grid[lin][col] & (WALL_STATE | FIRE_STATE))
                         continue;
 
                     // Cells with distance of 1.0 and 1.4 will be identified as risky cells.
                     if(fire_distance_grid[lin][col] < 1.5)
-                        risky_cells_grid[lin][col] = RISKY_CELL;
+                        cell_state_grid[lin][col] = (cell_state_grid[lin][col] & ~DANGER_STATE) | RISKY_STATE;
                 }
             }
         }
     }
 }
 
-/* ---------------- ---------------- ---------------- ---------------- ---------------- */
-/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
-/* ---------------- ---------------- ---------------- ---------------- ---------------- */
-
 /**
  * Calculates the distance of all the cells in the environment to the border of the fire (the distance to the closest cell with, considering the euclidean distance).
  * 
@@ -133,7 +135,7 @@ void calculate_distance_from_cells_to_fire()
     coordinate_set_collection line_set = {0, NULL}; // Collection where the main coordinate of each set is a line
     coordinate_set_collection column_set = {0, NULL}; // Collection where the main coordinate of each set is a column
 
-    fill_double_grid(fire_distance_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
+    fill_field_grid(fire_distance_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
     if(! cli_args.fire_is_present)
         return; // If the fire is not present, them the distance for all cells is set to 0.
     
@@ -149,7 +151,7 @@ void calculate_distance_from_cells_to_fire()
     {   
        for(int j = 0; j < cli_args.global_column_number; j++)
         {
-            if(fire_grid[i][j] == FIRE_CELL)
+            if(is_cell_with_fire((Location) {i,j}))
                 continue; // Distance remains as 0.
 
             double min_distance = 2e32;
@@ -196,6 +198,9 @@ void calculate_distance_from_cells_to_fire()
     deallocate_coordinate_sets(column_set);
 }
 
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
 
 /**
  * Adds the given coordinates to the specified coordinate set collection. 
@@ -259,10 +264,11 @@ static void extract_fire_coordinate_sets(coordinate_set_collection *collection,
     {
         for(int j = 0; j < second_dimension_limit; j++)
         {
-            if(fire_grid[i][j] == EMPTY_CELL)
+            Location fire_cell = line_direction ? (Location) {i,j} : (Location) {j,i};
+            if(! is_cell_with_fire(fire_cell))
                 continue;
 
-            add_to_coordinates_collection(collection, (line_direction ? (Location) {i,j} : (Location) {j, i}));         
+            add_to_coordinates_collection(collection, (Location) {i,j}); // The main coordinate is i, and the secondary is j.         
         }
     }
 }
@@ -0,0 +1,320 @@
+/*
+   File: fire_timeline.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the fire timeline of a simulation set. The spread of the fire depends only on the initial fire and the environment, so the fire after a given number of spreads (an epoch) is the same in every simulation of the set, whatever its seed or swept constants (the spread rate only changes the timesteps where each epoch begins). The fire of each epoch is given by the ignition epochs (see calculate_ignition_epochs), and the timeline stores, for each epoch, the fields derived from the fire (fire distances, fire floor field, risky cells, static field and distances to the exits), so the simulations copy them instead of recalculating them. Each epoch is calculated by the first simulation that reaches it.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"../headers/fire_timeline.h"
+#include"../headers/fire_dynamics.h"
+#include"../headers/fire_field.h"
+#include"../headers/static_field.h"
+#include"../headers/exit.h"
+#include"../headers/grid.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+typedef struct{
+    Field_Grid fire_distance_grid; // NULL until a simulation reaches the epoch.
+    Field_Grid fire_floor_field;
+    Cell_State_Grid fire_state_grid; // The FIRE_EPOCH_STATES flags (fire, risky and danger cells) of the epoch.
+    Field_Grid static_floor_field; // NULL until the static fields of the epoch are built (see build_static_fields).
+    double static_field_normalizer; // Sum of the static_floor_field, which is stored unnormalized (see compose_zheng_static_field).
+    Field_Grid distance_to_exits_grid;
+    bool is_distance_grid_shared; // Whether distance_to_exits_grid belongs to the previous epoch, since no exit was blocked in this one.
+    int num_blocked_exits;
+}Fire_Epoch;
+
+static Function_Status build_static_fields(int epoch_index);
+static Function_Status record_fire_fields(Fire_Epoch *epoch);
+static Function_Status record_static_fields(Fire_Epoch *epoch, Fire_Epoch *previous_epoch);
+static int count_blocked_exits();
+static void deallocate_fire_epoch(Fire_Epoch *epoch);
+
+static Fire_Epoch *fire_epochs = NULL; // One position per epoch, up to last_fire_epoch.
+static int last_fire_epoch = 0; // Epoch after which the fields no longer change.
+static int last_static_epoch = 0; // The static fields are built for every epoch up to this one.
+
+/**
+ * Starts the fire timeline of the current simulation set, marking the initial fire and calculating the fields of its first epoch.
+ *
+ * @note The static field of the first epoch doesn't consider the exits blocked by the initial fire, which are only verified after the first spread.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status prepare_fire_timeline()
+{
+    deallocate_fire_timeline();
+
+    // The first spread changes the fields even if the fire doesn't grow, since the blocked exits are then verified.
+    last_fire_epoch = last_ignition_epoch > 1 ? last_ignition_epoch : 1;
+
+    fire_epochs = calloc(last_fire_epoch + 1, sizeof(Fire_Epoch));
+    if(fire_epochs == NULL)
+    {
+        fprintf(stderr, "Failure during the allocation of the fire timeline.\n");
+        return FAILURE;
+    }
+
+    current_fire_epoch = 0;
+    last_static_epoch = 0;
+    mark_fire_cells();
+    calculate_fire_floor_field();
+    determine_risky_cells();
+    compose_zheng_static_field(NULL);
+    compose_distance_to_closest_exit();
+
+    if(record_fire_fields(&fire_epochs[0]) == FAILURE)
+        return FAILURE;
+
+    return record_static_fields(&fire_epochs[0], NULL);
+}
+
+/**
+ * Restores the fire and the fields of the first epoch, where every simulation begins.
+ */
+void restore_initial_fire_epoch()
+{
+    current_fire_epoch = 0;
+    copy_field_grid(fire_distance_grid, fire_epochs[0].fire_distance_grid);
+    copy_field_grid(exits_set.fire_floor_field, fire_epochs[0].fire_floor_field);
+    copy_cell_state_flags(cell_state_grid, fire_epochs[0].fire_state_grid, FIRE_EPOCH_STATES);
+    copy_field_grid(exits_set.static_floor_field, fire_epochs[0].static_floor_field);
+    exits_set.static_field_normalizer = fire_epochs[0].static_field_normalizer;
+    copy_field_grid(exits_set.distance_to_exits_grid, fire_epochs[0].distance_to_exits_grid);
+}
+
+/**
+ * Spreads the fire, moving the simulation to the next epoch and updating the fire distances, the fire floor field and the risky cells.
+ *
+ * @note The blocked exits and the static field are only updated at the beginning of the next timestep (see update_fields_after_fire_spread).
+ *
+ * @param has_the_fire_spread Pointer to a bool, set to true if the fields have changed.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status spread_fire(bool *has_the_fire_spread)
+{
+    if(current_fire_epoch >= last_fire_epoch)
+        return SUCCESS; // The fire occupies every cell it can reach, so nothing changes.
+
+    current_fire_epoch++;
+
+    Fire_Epoch *epoch = &fire_epochs[current_fire_epoch];
+    if(epoch->fire_distance_grid != NULL)
+    {
+        copy_field_grid(fire_distance_grid, epoch->fire_distance_grid);
+        copy_field_grid(exits_set.fire_floor_field, epoch->fire_floor_field);
+        copy_cell_state_flags(cell_state_grid, epoch->fire_state_grid, FIRE_EPOCH_STATES);
+    }
+    else
+    {
+        mark_ignited_cells();
+        calculate_fire_floor_field();
+        determine_risky_cells();
+
+        if(record_fire_fields(epoch) == FAILURE)
+            return FAILURE;
+    }
+
+    *has_the_fire_spread = true;
+
+    return SUCCESS;
+}
+
+/**
+ * Updates the blocked exits, the static field and the distances to the exits after the fire has spread to the current epoch.
+ *
+ * @note The static fields of the epochs are built in order, each from the previous one. When a restored checkpoint skips
+ * some epochs, they are built first, so the fields don't depend on the timestep where the simulation began.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status update_fields_after_fire_spread()
+{
+    if(current_fire_epoch <= last_static_epoch)
+    {
+        Fire_Epoch *epoch = &fire_epochs[current_fire_epoch];
+
+        check_for_exits_blocked_by_fire();
+        copy_field_grid(exits_set.static_floor_field, epoch->static_floor_field);
+        exits_set.static_field_normalizer = epoch->static_field_normalizer;
+        copy_field_grid(exits_set.distance_to_exits_grid, epoch->distance_to_exits_grid);
+
+        return SUCCESS;
+    }
+
+    int target_epoch = current_fire_epoch;
+
+    if(target_epoch > last_static_epoch + 1)
+    {
+        // The fire only grows, so the exits blocked in each skipped epoch are marked again as it is built, starting from the
+        // static field of the last epoch built.
+        reset_exits();
+        current_fire_epoch = last_static_epoch;
+        mark_fire_cells();
+        copy_field_grid(exits_set.static_floor_field, fire_epochs[last_static_epoch].static_floor_field);
+        exits_set.static_field_normalizer = fire_epochs[last_static_epoch].static_field_normalizer;
+    }
+
+    for(int epoch_index = last_static_epoch + 1; epoch_index <= target_epoch; epoch_index++)
+    {
+        current_fire_epoch = epoch_index;
+        mark_ignited_cells();
+        check_for_exits_blocked_by_fire();
+
+        if(build_static_fields(epoch_index) == FAILURE)
+            return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Deallocates the fire timeline.
+ */
+void deallocate_fire_timeline()
+{
+    for(int epoch_index = 0; fire_epochs != NULL && epoch_index <= last_fire_epoch; epoch_index++)
+        deallocate_fire_epoch(&fire_epochs[epoch_index]);
+
+    free(fire_epochs);
+    fire_epochs = NULL;
+    last_fire_epoch = 0;
+    last_static_epoch = 0;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Builds the static field and the distances to the exits of the epoch after last_static_epoch, whose blocked exits must be
+ * marked. While no exit is blocked, the static field only loses the cells that catch fire, which are removed from the one of
+ * the previous epoch, and the distances to the exits are those of the previous epoch.
+ *
+ * @note The exits set must hold the static field of the previous epoch.
+ *
+ * @param epoch_index Index of the epoch, which must be last_static_epoch + 1.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status build_static_fields(int epoch_index)
+{
+    Fire_Epoch *epoch = &fire_epochs[epoch_index];
+    Fire_Epoch *previous_epoch = &fire_epochs[epoch_index - 1];
+
+    if(previous_epoch->num_blocked_exits == count_blocked_exits())
+    {
+        remove_ignited_cells_from_zheng_static_field(NULL);
+        copy_field_grid(exits_set.distance_to_exits_grid, previous_epoch->distance_to_exits_grid);
+    }
+    else
+    {
+        compose_zheng_static_field(NULL);
+        compose_distance_to_closest_exit();
+        previous_epoch = NULL;
+    }
+
+    last_static_epoch = epoch_index;
+
+    return record_static_fields(epoch, previous_epoch);
+}
+
+/**
+ * Stores, in the given epoch, copies of the fire distances, the fire floor field and the fire, risky and danger cells.
+ *
+ * @param epoch The epoch where the fields are stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status record_fire_fields(Fire_Epoch *epoch)
+{
+    epoch->fire_distance_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    epoch->fire_floor_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    epoch->fire_state_grid = allocate_cell_state_grid(cli_args.global_line_number, cli_args.global_column_number);
+    if(epoch->fire_distance_grid == NULL || epoch->fire_floor_field == NULL || epoch->fire_state_grid == NULL)
+    {
+        fprintf(stderr, "Failure during the allocation of the fields of a fire epoch.\n");
+        return FAILURE;
+    }
+
+    copy_field_grid(epoch->fire_distance_grid, fire_distance_grid);
+    copy_field_grid(epoch->fire_floor_field, exits_set.fire_floor_field);
+    copy_cell_state_flags(epoch->fire_state_grid, cell_state_grid, FIRE_EPOCH_STATES);
+
+    return SUCCESS;
+}
+
+/**
+ * Stores, in the given epoch, copies of the static field and of the distances to the exits, and the number of blocked exits.
+ *
+ * @param epoch The epoch where the fields are stored.
+ * @param previous_epoch The previous epoch, whose distances to the exits are shared, or NULL if the distances must be copied.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status record_static_fields(Fire_Epoch *epoch, Fire_Epoch *previous_epoch)
+{
+    epoch->num_blocked_exits = count_blocked_exits();
+
+    epoch->static_floor_field = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    if(epoch->static_floor_field == NULL)
+    {
+        fprintf(stderr, "Failure during the allocation of the static field of a fire epoch.\n");
+        return FAILURE;
+    }
+    copy_field_grid(epoch->static_floor_field, exits_set.static_floor_field);
+    epoch->static_field_normalizer = exits_set.static_field_normalizer;
+
+    if(previous_epoch != NULL)
+    {
+        epoch->distance_to_exits_grid = previous_epoch->distance_to_exits_grid;
+        epoch->is_distance_grid_shared = true;
+
+        return SUCCESS;
+    }
+
+    epoch->distance_to_exits_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
+    if(epoch->distance_to_exits_grid == NULL)
+    {
+        fprintf(stderr, "Failure during the allocation of the distances to the exits of a fire epoch.\n");
+        return FAILURE;
+    }
+    copy_field_grid(epoch->distance_to_exits_grid, exits_set.distance_to_exits_grid);
+
+    return SUCCESS;
+}
+
+/**
+ * Counts the exits blocked by fire. Since the fire only grows, two epochs have the same blocked exits if they have as many.
+ *
+ * @return The number of blocked exits.
+ */
+static int count_blocked_exits()
+{
+    int num_blocked_exits = 0;
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+    {
+        if(exits_set.list[exit_index]->is_blocked_by_fire)
+            num_blocked_exits++;
+    }
+
+    return num_blocked_exits;
+}
+
+/**
+ * Deallocates the fields of an epoch.
+ *
+ * @param epoch The epoch to be deallocated.
+ */
+static void deallocate_fire_epoch(Fire_Epoch *epoch)
+{
+    deallocate_grid((void **) epoch->fire_distance_grid, cli_args.global_line_number);
+    deallocate_grid((void **) epoch->fire_floor_field, cli_args.global_line_number);
+    deallocate_grid((void **) epoch->fire_state_grid, cli_args.global_line_number);
+    deallocate_grid((void **) epoch->static_floor_field, cli_args.global_line_number);
+
+    if(! epoch->is_distance_grid_shared)
+        deallocate_grid((void **) epoch->distance_to_exits_grid, cli_args.global_line_number);
+}
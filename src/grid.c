@@ -8,6 +8,7 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<stdbool.h>
+#include<string.h>
 
 #include"../headers/grid.h"
 #include"../headers/fire_dynamics.h"
@@ -17,8 +18,8 @@
 Int_Grid obstacle_grid = NULL; // Grid containing walls and obstacles.
                                // Contains cells with either IMPASSABLE_OBJECT or EMPTY_CELL values.
                                // Any cell with an exit is assigned IMPASSABLE_OBJECT value.
-Int_Grid risky_cells_grid = NULL; // Grid containing either 1 for cells that are one unit distance between the corder of the fire and a wall (or impassable obstacle) or 0 otherwise. 
-Int_Grid heatmap_grid = NULL; // Grid containing the count of pedestrian visits per cell.
+Cell_State_Grid cell_state_grid = NULL; // Grid holding, in one byte per cell, the flags (see grid.h) of walls, exits, blocked exits, fire, risky and danger cells, and pedestrians.
+                                       // Answers every query about the state of a cell with a single load.
 
 /**
  * Dynamically allocates an integer matrix of dimensions determined by the function parameters.
@@ -28,6 +29,7 @@ Int_Grid heatmap_grid = NULL; // Grid containing the count of pedestrian visits
  * @return A NULL pointer, on error, or an Integer_Grid if the grid was successfully allocated.
  * 
  * @note All positions of the matrix are already zeroed.
+ * @note The cells are stored in a single contiguous block (line after line), pointed by the first line. This allows whole grids to be copied, reduced or serialized as flat arrays.
  */
 Int_Grid allocate_integer_grid(int line_number, int column_number)
 {
@@ -43,32 +45,33 @@ Int_Grid allocate_integer_grid(int line_number, int column_number)
         fprintf(stderr, "Failed to allocate memory for the lines of an integer grid.\n");
         return NULL;
     }
-    
-    for(int i = 0; i < line_number; i++)
+
+    new_grid[0] = calloc((size_t) line_number * column_number, sizeof(int));
+    if(new_grid[0] == NULL)
     {
-        new_grid[i] = calloc(column_number, sizeof(int));
-        if(new_grid[i] == NULL)
-        {
-            deallocate_grid((void **) new_grid, i);
+        free(new_grid);
 
-            fprintf(stderr, "Failed to allocate memory for the columns of the line %d of an integer grid.\n", i);
-            return NULL;
-        }
+        fprintf(stderr, "Failed to allocate memory for the cells of an integer grid.\n");
+        return NULL;
     }
 
+    for(int i = 1; i < line_number; i++)
+        new_grid[i] = new_grid[0] + (size_t) i * column_number;
+
     return new_grid;
 }
 
 /**
- * Dynamically allocates a double matrix of dimensions determined by the function parameters.
+ * Dynamically allocates a matrix of Field_Value of dimensions determined by the function parameters.
  *
  * @param line_number Number of lines of the grid.
  * @param column_number Number of columns of the grid.
- * @return A NULL pointer, on error, or an Double_Grid if the grid was successfully allocated.
+ * @return A NULL pointer, on error, or a Field_Grid if the grid was successfully allocated.
  * 
  * @note All positions of the matrix are already zeroed.
+ * @note The cells are stored in a single contiguous block (line after line), pointed by the first line.
  */
-Double_Grid allocate_double_grid(int line_number, int column_number)
+Field_Grid allocate_field_grid(int line_number, int column_number)
 {
     if(line_number <= 0 || column_number <= 0)
     {
@@ -76,25 +79,65 @@ Double_Grid allocate_double_grid(int line_number, int column_number)
         return NULL;
     }
 
-    double **new_grid = malloc(sizeof(double *) * line_number);
+    Field_Grid new_grid = malloc(sizeof(Field_Value *) * line_number);
     if( new_grid == NULL )
     {
-        fprintf(stderr, "Failed to allocate memory for the lines of a double grid.\n");
+        fprintf(stderr, "Failed to allocate memory for the lines of a field grid.\n");
         return NULL;
     }
-    
-    for(int i = 0; i < line_number; i++)
+
+    new_grid[0] = calloc((size_t) line_number * column_number, sizeof(Field_Value));
+    if(new_grid[0] == NULL)
     {
-        new_grid[i] = calloc(column_number, sizeof(double));
-        if(new_grid[i] == NULL)
-        {
-            deallocate_grid((void **) new_grid, i);
+        free(new_grid);
 
-            fprintf(stderr, "Failed to allocate memory for the columns of the line %d of a double grid.\n", i);
-            return NULL;
-        }
+        fprintf(stderr, "Failed to allocate memory for the cells of a field grid.\n");
+        return NULL;
     }
 
+    for(int i = 1; i < line_number; i++)
+        new_grid[i] = new_grid[0] + (size_t) i * column_number;
+
+    return new_grid;
+}
+
+/**
+ * Dynamically allocates a cell state grid of dimensions determined by the function parameters.
+ *
+ * @param line_number Number of lines of the grid.
+ * @param column_number Number of columns of the grid.
+ * @return A NULL pointer, on error, or a Cell_State_Grid if the grid was successfully allocated.
+ * 
+ * @note All positions of the matrix are already zeroed (no flags).
+ * @note The cells are stored in a single contiguous block (line after line), pointed by the first line.
+ */
+Cell_State_Grid allocate_cell_state_grid(int line_number, int column_number)
+{
+    if(line_number <= 0 || column_number <= 0)
+    {
+        fprintf(stderr, "At least one of the grid dimensions was negative or zero.\n");
+        return NULL;
+    }
+
+    Cell_State_Grid new_grid = malloc(sizeof(uint8_t *) * line_number);
+    if( new_grid == NULL )
+    {
+        fprintf(stderr, "Failed to allocate memory for the lines of a cell state grid.\n");
+        return NULL;
+    }
+
+    new_grid[0] = calloc((size_t) line_number * column_number, sizeof(uint8_t));
+    if(new_grid[0] == NULL)
+    {
+        free(new_grid);
+
+        fprintf(stderr, "Failed to allocate memory for the cells of a cell state grid.\n");
+        return NULL;
+    }
+
+    for(int i = 1; i < line_number; i++)
+        new_grid[i] = new_grid[0] + (size_t) i * column_number;
+
     return new_grid;
 }
 
@@ -132,33 +175,33 @@ Function_Status fill_integer_grid(Int_Grid integer_grid, int line_number, int co
 }
 
 /**
- * Assign the given value to all positions of the provided double grid.
+ * Assign the given value to all positions of the provided field grid.
  *
- * @param double_grid A double grid to be reset. 
+ * @param field_grid A field grid to be reset. 
  * @param line_number Number of lines of the grid.
  * @param column_number Number of columns of the grid.
  * @param value The value to be assigned to all positions.
  * 
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
  */
-Function_Status fill_double_grid(Double_Grid double_grid, int line_number, int column_number, double value)
+Function_Status fill_field_grid(Field_Grid field_grid, int line_number, int column_number, double value)
 {
-    if(double_grid == NULL)
+    if(field_grid == NULL)
     {
-        fprintf(stderr, "The Double_Grid passed to 'fill_double_grid' was a NULL pointer.\n");
+        fprintf(stderr, "The Field_Grid passed to 'fill_field_grid' was a NULL pointer.\n");
         return FAILURE;
     }
 
     for(int i = 0; i < line_number; i++)
     {
-        if(double_grid[i] == NULL)
+        if(field_grid[i] == NULL)
         {
-            fprintf(stderr, "The line %d of the Double_Grid passed to 'fill_double_grid' was a NULL pointer.\n", i);
+            fprintf(stderr, "The line %d of the Field_Grid passed to 'fill_field_grid' was a NULL pointer.\n", i);
             return FAILURE;
         }
 
         for(int h = 0; h < column_number; h++)
-            double_grid[i][h] = value;
+            field_grid[i][h] = value;
     }
 
     return SUCCESS;
@@ -181,59 +224,81 @@ Function_Status copy_integer_grid(Int_Grid destination, Int_Grid source)
         return FAILURE;
     }
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    if(destination[0] == NULL || source[0] == NULL)
     {
-        if(destination[i] == NULL || source[i] == NULL)
-        {
-            fprintf(stderr, "The line %d of destination or/and source in 'copy_integer_grid' was a null pointer.\n", i);
-            return FAILURE;
-        }
-
-        for(int h = 0; h < cli_args.global_column_number; h++)
-        {
-            destination[i][h] = source[i][h];
-        }
+        fprintf(stderr, "The cells of destination or/and source in 'copy_integer_grid' were a null pointer.\n");
+        return FAILURE;
     }
 
+    memcpy(destination[0], source[0], sizeof(int) * cli_args.global_line_number * cli_args.global_column_number);
+
     return SUCCESS;
 }
 
 /**
  * Copy the content of the source grid to the destination grid.
  *
- * @param destination Double grid where the content is to be copied.
- * @param source Double grid to be copied.
+ * @param destination Field grid where the content is to be copied.
+ * @param source Field grid to be copied.
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
  * 
  * @note Both grids must be of  global size (lines and columns). Otherwise, undefined behavior will happen.
  */
-Function_Status copy_double_grid(Double_Grid destination, Double_Grid source)
+Function_Status copy_field_grid(Field_Grid destination, Field_Grid source)
 {
     if(destination == NULL || source == NULL)
     {
-        fprintf(stderr, "The destination or/and source grids received by 'copy_double_grid' was a null pointer.\n");
+        fprintf(stderr, "The destination or/and source grids received by 'copy_field_grid' was a null pointer.\n");
         return FAILURE;
     }
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    if(destination[0] == NULL || source[0] == NULL)
     {
-        if(destination[i] == NULL || source[i] == NULL)
-        {
-            fprintf(stderr, "The line %d of destination or/and source in 'copy_double_grid' was a null pointer.\n", i);
-            return FAILURE;
-        }
-
-        for(int h = 0; h < cli_args.global_column_number; h++)
-        {
-            destination[i][h] = source[i][h];
-        }
+        fprintf(stderr, "The cells of destination or/and source in 'copy_field_grid' were a null pointer.\n");
+        return FAILURE;
     }
 
+    memcpy(destination[0], source[0], sizeof(Field_Value) * cli_args.global_line_number * cli_args.global_column_number);
+
     return SUCCESS;
 }
 
 
 
+/**
+ * Copies the given flags of every cell of the source grid to the destination grid, keeping the other flags of the destination.
+ *
+ * @param destination Cell state grid where the flags are to be copied.
+ * @param source Cell state grid whose flags are copied.
+ * @param flags The flags to be copied (e.g., FIRE_EPOCH_STATES).
+ * 
+ * @note Both grids must be of global size (lines and columns). Otherwise, undefined behavior will happen.
+ */
+void copy_cell_state_flags(Cell_State_Grid destination, Cell_State_Grid source, uint8_t flags)
+{
+    uint8_t *restrict destination_cells = destination[0];
+    const uint8_t *restrict source_cells = source[0];
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+
+    for(size_t k = 0; k < num_cells; k++)
+        destination_cells[k] = (destination_cells[k] & ~flags) | (source_cells[k] & flags);
+}
+
+/**
+ * Clears the given flags in every cell of the grid.
+ *
+ * @param cell_state Cell state grid whose flags are cleared.
+ * @param flags The flags to be cleared.
+ */
+void clear_cell_state_flags(Cell_State_Grid cell_state, uint8_t flags)
+{
+    uint8_t *cells = cell_state[0];
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+
+    for(size_t k = 0; k < num_cells; k++)
+        cells[k] &= ~flags;
+}
+
 /**
  * Copy the cells that aren't EMPTY_CELL from the source grid to the destination grid.
  *
@@ -275,14 +340,14 @@ Function_Status copy_non_empty_cells(Int_Grid destination, Int_Grid source)
 /**
  * Identify the cells that aren't EMPTY_CELL from the source grid and replace the cells in the same coordinates of the destination grid with value.
  *
- * @param destination Double grid where the content is to be copied.
+ * @param destination Field grid where the content is to be copied.
  * @param source Int grid fro which the data will be extracted.
  * @param value The value to be used as replacement.
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
  * 
  * @note Both grids must be of global size (lines and columns). Otherwise, undefined behavior will happen.
  */
-Function_Status replace_non_empty_cells(Double_Grid destination, Int_Grid source, double value)
+Function_Status replace_non_empty_cells(Field_Grid destination, Int_Grid source, double value)
 {
     if(destination == NULL || source == NULL)
     {
@@ -329,37 +394,48 @@ Function_Status sum_grids(Int_Grid destination, Int_Grid source)
         return FAILURE;
     }
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    if(destination[0] == NULL || source[0] == NULL)
     {
-        if(destination[i] == NULL || source[i] == NULL)
-        {
-            fprintf(stderr, "The line %d of destination or/and source in 'sum_grids' was a null pointer.\n", i);
-            return FAILURE;
-        }
-
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            destination[i][j] += source[i][j];
-        }
+        fprintf(stderr, "The cells of destination or/and source in 'sum_grids' were a null pointer.\n");
+        return FAILURE;
     }
 
+    sum_integer_blocks(destination[0], source[0], (size_t) cli_args.global_line_number * cli_args.global_column_number);
+
     return SUCCESS;
 }
 
+/**
+ * Adds, element by element, the values of the source block to the destination block.
+ * 
+ * @note Both blocks are traversed linearly and can't overlap, allowing the compiler to vectorize the loop. Used to reduce 
+ * whole grids (through their contiguous cell block) or parts of them.
+ * 
+ * @param destination Block of integers that will be updated with the summed values.
+ * @param source Block of integers that provides the values to be added.
+ * @param length Number of integers in each block.
+ */
+void sum_integer_blocks(int *restrict destination, const int *restrict source, size_t length)
+{
+    for(size_t index = 0; index < length; index++)
+        destination[index] += source[index];
+}
+
 /**
  * Deallocate all memory assigned to a integer grid.
  *
- * @param grid An integer or double grid, casted to (void **).
+ * @param grid An integer or field grid, casted to (void **).
  * @param line_number Number of lines of the grid that should be deallocated.
+ * 
+ * @note Since the cells of a grid are stored in a single block, pointed by its first line, only that block and the lines are freed.
  */
 void deallocate_grid(void **grid, int line_number)
 {
     if(grid != NULL)
     {
-        for(int i = 0; i < line_number; i++)
-        {
-            free(grid[i]);
-        }
+        if(line_number > 0)
+            free(grid[0]);
+
         free(grid);
 
         grid = NULL;
@@ -0,0 +1,241 @@
+/*
+   File: heatmap.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the heatmap grids, which count the pedestrian visits per cell, and functions to split the counting in timestep windows, as well as to transfer and reduce the heatmaps accumulated by the simulation workers.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<unistd.h>
+#include<errno.h>
+
+#include"../headers/heatmap.h"
+#include"../headers/grid.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+Int_Grid heatmap_grid = NULL; // Grid containing the count of pedestrian visits per cell.
+                              // When the heatmap is split in timestep windows, holds only the counts of the window in progress.
+Int_Grid *heatmap_windows = NULL; // The counts of every closed timestep window (only used if cli_args.heatmap_window is positive).
+int num_heatmap_windows = 0; // Number of timestep windows closed so far in the current simulation set.
+
+static int heatmap_windows_capacity = 0; // Number of window grids allocated. They are reused from one simulation set to the next.
+
+static Function_Status ensure_heatmap_window(int window_index);
+static Function_Status write_full_block(int file_descriptor, const void *block, size_t size);
+static Function_Status read_full_block(int file_descriptor, void *block, size_t size);
+
+/**
+ * Adds the counts of the window in progress (stored in heatmap_grid) to the window of the given index and resets heatmap_grid.
+ *
+ * @note Windows of the same index, but from different simulations, are accumulated together.
+ *
+ * @param window_index Index of the timestep window being closed.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status close_heatmap_window(int window_index)
+{
+    if(ensure_heatmap_window(window_index) == FAILURE)
+        return FAILURE;
+
+    if(sum_grids(heatmap_windows[window_index], heatmap_grid) == FAILURE)
+        return FAILURE;
+
+    return fill_integer_grid(heatmap_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
+}
+
+/**
+ * Zeroes the heatmap_grid and all the timestep windows, keeping them allocated for the next simulation set.
+ */
+void clear_heatmap_data()
+{
+    fill_integer_grid(heatmap_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
+
+    for(int window_index = 0; window_index < heatmap_windows_capacity; window_index++)
+        fill_integer_grid(heatmap_windows[window_index], cli_args.global_line_number, cli_args.global_column_number, 0);
+
+    num_heatmap_windows = 0;
+}
+
+/**
+ * Writes the heatmap data accumulated by this process (the number of windows, heatmap_grid and every closed window) to the given file descriptor.
+ *
+ * @note Used by the simulation workers to send their private heatmaps to the main process.
+ *
+ * @param file_descriptor File descriptor where the data will be written.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status write_heatmap_data(int file_descriptor)
+{
+    size_t grid_size = sizeof(int) * cli_args.global_line_number * cli_args.global_column_number;
+
+    if(write_full_block(file_descriptor, &num_heatmap_windows, sizeof(int)) == FAILURE)
+        return FAILURE;
+
+    if(write_full_block(file_descriptor, heatmap_grid[0], grid_size) == FAILURE)
+        return FAILURE;
+
+    for(int window_index = 0; window_index < num_heatmap_windows; window_index++)
+    {
+        if(write_full_block(file_descriptor, heatmap_windows[window_index][0], grid_size) == FAILURE)
+            return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Reads the heatmap data written by write_heatmap_data from the given file descriptor and sums it to the heatmap_grid and windows of this process.
+ *
+ * @param file_descriptor File descriptor from which the data will be read.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status read_and_reduce_heatmap_data(int file_descriptor)
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+    int received_windows = 0;
+
+    if(read_full_block(file_descriptor, &received_windows, sizeof(int)) == FAILURE)
+        return FAILURE;
+
+    int *received_block = malloc(sizeof(int) * num_cells);
+    if(received_block == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the buffer used to receive heatmap data.\n");
+        return FAILURE;
+    }
+
+    Function_Status status = read_full_block(file_descriptor, received_block, sizeof(int) * num_cells);
+    if(status == SUCCESS)
+        sum_integer_blocks(heatmap_grid[0], received_block, num_cells);
+
+    for(int window_index = 0; window_index < received_windows && status == SUCCESS; window_index++)
+    {
+        status = read_full_block(file_descriptor, received_block, sizeof(int) * num_cells);
+        if(status == SUCCESS)
+            status = ensure_heatmap_window(window_index);
+
+        if(status == SUCCESS)
+            sum_integer_blocks(heatmap_windows[window_index][0], received_block, num_cells);
+    }
+
+    free(received_block);
+
+    return status;
+}
+
+/**
+ * Deallocates all timestep window grids.
+ */
+void deallocate_heatmap_windows()
+{
+    for(int window_index = 0; window_index < heatmap_windows_capacity; window_index++)
+        deallocate_grid((void **) heatmap_windows[window_index], cli_args.global_line_number);
+
+    free(heatmap_windows);
+    heatmap_windows = NULL;
+    heatmap_windows_capacity = 0;
+    num_heatmap_windows = 0;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Guarantees that the window of the given index (and all windows before it) exist and are counted in num_heatmap_windows.
+ *
+ * @param window_index Index of the window.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status ensure_heatmap_window(int window_index)
+{
+    if(window_index >= heatmap_windows_capacity)
+    {
+        Int_Grid *new_list = realloc(heatmap_windows, sizeof(Int_Grid) * (window_index + 1));
+        if(new_list == NULL)
+        {
+            fprintf(stderr, "Failure in the realloc of the heatmap_windows list.\n");
+            return FAILURE;
+        }
+        heatmap_windows = new_list;
+
+        for(; heatmap_windows_capacity <= window_index; heatmap_windows_capacity++)
+        {
+            heatmap_windows[heatmap_windows_capacity] = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
+            if(heatmap_windows[heatmap_windows_capacity] == NULL)
+            {
+                fprintf(stderr, "Failure during the allocation of the heatmap window %d.\n", heatmap_windows_capacity);
+                return FAILURE;
+            }
+        }
+    }
+
+    if(window_index >= num_heatmap_windows)
+        num_heatmap_windows = window_index + 1;
+
+    return SUCCESS;
+}
+
+/**
+ * Writes the whole block to the file descriptor, retrying after partial writes and interruptions.
+ *
+ * @param file_descriptor File descriptor where the block will be written.
+ * @param block Data to be written.
+ * @param size Size of the block, in bytes.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status write_full_block(int file_descriptor, const void *block, size_t size)
+{
+    const char *position = block;
+
+    while(size > 0)
+    {
+        ssize_t written = write(file_descriptor, position, size);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            perror("Failure while writing heatmap data");
+            return FAILURE;
+        }
+
+        position += written;
+        size -= written;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Reads the whole block from the file descriptor, retrying after partial reads and interruptions.
+ *
+ * @param file_descriptor File descriptor from which the block will be read.
+ * @param block Where the data will be stored.
+ * @param size Size of the block, in bytes.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status read_full_block(int file_descriptor, void *block, size_t size)
+{
+    char *position = block;
+
+    while(size > 0)
+    {
+        ssize_t received = read(file_descriptor, position, size);
+        if(received < 0 && errno == EINTR)
+            continue;
+
+        if(received <= 0)
+        {
+            fprintf(stderr, "Failure while reading heatmap data: the worker ended before sending it.\n");
+            return FAILURE;
+        }
+
+        position += received;
+        size -= received;
+    }
+
+    return SUCCESS;
+}
@@ -13,10 +13,12 @@
 #include<time.h>
 
 #include"../headers/grid.h"
+#include"../headers/heatmap.h"
 #include"../headers/exit.h"
 #include"../headers/fire_field.h"
 #include"../headers/fire_dynamics.h"
 #include"../headers/pedestrian.h"
+#include"../headers/simulation.h"
 #include"../headers/initialization.h"
 #include"../headers/cli_processing.h"
 #include"../headers/shared_resources.h"
@@ -72,7 +74,7 @@ Function_Status open_output_file(FILE **output_file)
         // no filename was provided
         if(strcmp(cli_args.output_filename, "") == 0)
         {
-            char *output_type_name;
+            char *output_type_name = "";
             if(cli_args.output_format == OUTPUT_VISUALIZATION)
                 output_type_name = "visual";
             else if(cli_args.output_format == OUTPUT_TIMESTEPS_COUNT)
@@ -106,23 +108,22 @@ Function_Status open_output_file(FILE **output_file)
 }
 
 /**
- * Allocates the integer grids necessary for the program (environment, exits, pedestrian and heatmap grids).
+ * Allocates the grids necessary for the program (environment, cell state, fire, pedestrian and heatmap grids).
  *  
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
 */
 Function_Status allocate_grids()
 {
     obstacle_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    exits_only_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    fire_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
+    cell_state_grid = allocate_cell_state_grid(cli_args.global_line_number, cli_args.global_column_number);
+    ignition_epoch_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
     initial_fire_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
     pedestrian_position_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    fire_distance_grid = allocate_double_grid(cli_args.global_line_number, cli_args.global_column_number);
+    fire_distance_grid = allocate_field_grid(cli_args.global_line_number, cli_args.global_column_number);
     heatmap_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    risky_cells_grid = allocate_integer_grid(cli_args.global_line_number, cli_args.global_column_number);
-    if(obstacle_grid == NULL || exits_only_grid == NULL || pedestrian_position_grid == NULL 
-    || fire_grid == NULL     || heatmap_grid == NULL    || fire_distance_grid == NULL
-    || initial_fire_grid == NULL     || risky_cells_grid == NULL)
+    if(obstacle_grid == NULL || cell_state_grid == NULL || pedestrian_position_grid == NULL 
+    || ignition_epoch_grid == NULL || heatmap_grid == NULL    || fire_distance_grid == NULL
+    || initial_fire_grid == NULL)
     {
         fprintf(stderr,"Failure during allocation of the integer grids with dimensions: %d x %d.\n", cli_args.global_line_number, cli_args.global_column_number);
         return FAILURE;
@@ -143,6 +144,24 @@ Function_Status load_environment()
     if(open_environment_file(&environment_file) == FAILURE)
         return FAILURE;
 
+    Function_Status status = read_environment(environment_file);
+
+    fclose(environment_file);
+
+    return status;
+}
+
+/**
+ * Reads an environment (its dimensions, followed by one line of symbols per line of the grid) from the given stream,
+ * allocating the grids and adding the exits and pedestrians it contains, according to the environment origin.
+ * 
+ * @note The stream isn't closed. Besides files, it may be a memory buffer opened with fmemopen (see zheng_create_context).
+ * 
+ * @param environment_file Stream where the environment is stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+*/
+Function_Status read_environment(FILE *environment_file)
+{
     if( fscanf(environment_file,"%d %d", &(cli_args.global_line_number), &(cli_args.global_column_number)) != 2)
     {
         fprintf(stderr, "Environment dimensions weren't found in the first line of the file.\n");
@@ -155,14 +174,11 @@ Function_Status load_environment()
     if(fill_integer_grid(pedestrian_position_grid, cli_args.global_line_number, cli_args.global_column_number, 0) == FAILURE)
         return FAILURE;
 
-    if(fill_integer_grid(exits_only_grid, cli_args.global_line_number, cli_args.global_column_number, EMPTY_CELL) == FAILURE)
-        return FAILURE;    
-
     if(fill_integer_grid(initial_fire_grid, cli_args.global_line_number, cli_args.global_column_number, EMPTY_CELL) == FAILURE)
         return FAILURE;
 
     char read_char = '\0';
-    int returned_value = fscanf(environment_file,"%c",&read_char);// responsible for eliminating the '\n' after the environment dimensions.
+    fscanf(environment_file,"%c",&read_char);// responsible for eliminating the '\n' after the environment dimensions.
     for(int i = 0; i < cli_args.global_line_number; i++)
     {
         int h = 0;
@@ -194,8 +210,6 @@ Function_Status load_environment()
 
     set_all_private_grids();
 
-    fclose(environment_file);
-
     return SUCCESS;
 }
 
@@ -209,6 +223,12 @@ Function_Status generate_environment()
     if(allocate_grids() == FAILURE)
         return FAILURE;
 
+    if(fill_integer_grid(pedestrian_position_grid, cli_args.global_line_number, cli_args.global_column_number, 0) == FAILURE)
+        return FAILURE;
+
+    if(fill_integer_grid(initial_fire_grid, cli_args.global_line_number, cli_args.global_column_number, EMPTY_CELL) == FAILURE)
+        return FAILURE; // The generated room has no fire.
+
     for(int i = 0; i < cli_args.global_line_number; i++)
     {
         for(int h = 0; h < cli_args.global_column_number; h++)
@@ -216,7 +236,10 @@ Function_Status generate_environment()
             if(i > 0 && i < cli_args.global_line_number - 1 && h > 0 && h < cli_args.global_column_number - 1)
                 obstacle_grid[i][h] = EMPTY_CELL;
             else
+            {
                 obstacle_grid[i][h] = IMPASSABLE_OBJECT;
+                cell_state_grid[i][h] |= WALL_STATE;
+            }
         }
     }
 
@@ -287,8 +310,7 @@ Function_Status get_next_simulation_set(FILE *auxiliary_file, int *exit_number)
    
     bool new_exit = true; // True for a new exit, False for an expansion over the last new exit.
 
-    if( fill_integer_grid(exits_only_grid, cli_args.global_line_number, cli_args.global_column_number, EMPTY_CELL) == FAILURE)
-        return FAILURE; // Resets the exits_only_grid, allowing for it to be reused.
+    clear_cell_state_flags(cell_state_grid, ANY_EXIT_STATE); // Removes the exits of the previous simulation set.
 
     while(1)
     {
@@ -315,7 +337,7 @@ Function_Status get_next_simulation_set(FILE *auxiliary_file, int *exit_number)
                 return FAILURE;
         }
 
-        exits_only_grid[temp_coordinates.lin][temp_coordinates.col] = EXIT_CELL;
+        cell_state_grid[temp_coordinates.lin][temp_coordinates.col] |= EXIT_STATE;
 
         if(read_char == '+')
             new_exit = false;
@@ -337,6 +359,35 @@ Function_Status get_next_simulation_set(FILE *auxiliary_file, int *exit_number)
     return SUCCESS;
 }
 
+/**
+ * Deallocates the environment: the grids allocated by allocate_grids, the pedestrians, the exits and the structures derived
+ * from them during the simulations.
+ */
+void deallocate_environment()
+{
+    deallocate_pedestrians();
+    deallocate_exits();
+
+    deallocate_grid((void **) obstacle_grid, cli_args.global_line_number);
+    deallocate_grid((void **) cell_state_grid, cli_args.global_line_number);
+    deallocate_grid((void **) ignition_epoch_grid, cli_args.global_line_number);
+    deallocate_ignition_order();
+    deallocate_grid((void **) initial_fire_grid, cli_args.global_line_number);
+    deallocate_grid((void **) pedestrian_position_grid, cli_args.global_line_number);
+    deallocate_grid((void **) fire_distance_grid, cli_args.global_line_number);
+    deallocate_grid((void **) heatmap_grid, cli_args.global_line_number);
+    obstacle_grid = NULL;
+    cell_state_grid = NULL;
+    ignition_epoch_grid = NULL;
+    initial_fire_grid = NULL;
+    pedestrian_position_grid = NULL;
+    fire_distance_grid = NULL;
+    heatmap_grid = NULL;
+
+    deallocate_heatmap_windows();
+    deallocate_simulation_set_fields();
+}
+
 /**
  * Simply counts the number of empty cells in the environment (i.e, cells not occupied by walls or obstacles).
  * 
@@ -397,6 +448,7 @@ static Function_Status symbol_processing(char read_char, Location coordinates)
     {
         case '#':
             obstacle_grid[coordinates.lin][coordinates.col] = IMPASSABLE_OBJECT;
+            cell_state_grid[coordinates.lin][coordinates.col] |= WALL_STATE;
             break;
         case '_':
             if(origin_uses_static_exits() == true)
@@ -405,11 +457,14 @@ static Function_Status symbol_processing(char read_char, Location coordinates)
                     return FAILURE;
                 
                 obstacle_grid[coordinates.lin][coordinates.col] = IMPASSABLE_OBJECT;
-                exits_only_grid[coordinates.lin][coordinates.col] = EXIT_CELL;
+                cell_state_grid[coordinates.lin][coordinates.col] |= WALL_STATE | EXIT_STATE;
             }
             else
+            {
                 obstacle_grid[coordinates.lin][coordinates.col] = IMPASSABLE_OBJECT;
+                cell_state_grid[coordinates.lin][coordinates.col] |= WALL_STATE;
                 // If a exit is located in the middle of the environment a Wall is still put there.
+            }
             break;
         case '.':
             obstacle_grid[coordinates.lin][coordinates.col] = EMPTY_CELL;
@@ -423,6 +478,7 @@ static Function_Status symbol_processing(char read_char, Location coordinates)
                     return FAILURE;
 
                 pedestrian_position_grid[coordinates.lin][coordinates.col] = pedestrian_set.list[pedestrian_set.num_pedestrians - 1]->id;
+                cell_state_grid[coordinates.lin][coordinates.col] |= OCCUPIED_STATE;
             }
             obstacle_grid[coordinates.lin][coordinates.col] = EMPTY_CELL;
 
@@ -7,13 +7,16 @@
 
 #include<stdio.h>
 #include<stdlib.h>
+#include<string.h>
 #include<stdbool.h>
 #include<math.h>
 
 #include"../headers/exit.h"
 #include"../headers/dynamic_field.h"
 #include"../headers/grid.h"
+#include"../headers/heatmap.h"
 #include"../headers/pedestrian.h"
+#include"../headers/cell_graph.h"
 #include"../headers/cli_processing.h"
 #include"../headers/shared_resources.h"
 #include"../headers/static_field.h"
@@ -21,6 +24,7 @@
 #include"../headers/fire_field.h"
 
 #include"../headers/printing_utilities.h"
+#include"../headers/profiling.h"
 
 Int_Grid pedestrian_position_grid = NULL; // Grid containing pedestrians at their respective positions.
 
@@ -30,20 +34,67 @@ typedef struct cell_conflict{
     int pedestrian_allowed;
 }cell_conflict;
 
-Pedestrian_Set pedestrian_set = {NULL,0,0};
+Pedestrian_Set pedestrian_set = {NULL,0,0,0};
 
 static Pedestrian create_pedestrian(Location ped_coordinates);
-static void calculate_transition_probabilities(Pedestrian current_pedestrian);
+static inline void calculate_transition_probabilities(Pedestrian current_pedestrian, int terms) __attribute__((always_inline));
 static Location transition_selection(Pedestrian current_pedestrian);
 static Location calculate_inertia_mask(Location previous, Location current);
-static bool evaluate_pedestrian_vision(Pedestrian current_pedestrian);
 static bool is_vision_blocked(Location origin, Location destination);
 static bool is_pedestrian_dead(Pedestrian current_pedestrian);
 
+// Terms of the transition probabilities that are only calculated by the variants of calculate_transition_probabilities that include them.
+#define DYNAMIC_FIELD_TERM 0x1
+#define FIRE_FIELD_TERM 0x2
+#define INERTIA_TERM 0x4
+#define FIRE_TERMS 0x8 // The vision of the exits and the avoidance of the cells with fire or in danger, which only matter when there is fire.
+#define ALL_TRANSITION_TERMS (DYNAMIC_FIELD_TERM | FIRE_FIELD_TERM | INERTIA_TERM | FIRE_TERMS)
+
+// Defines the variant of calculate_transition_probabilities with the given terms, where the others are compiled out.
+#define DEFINE_TRANSITION_VARIANT(terms) \
+    static void calculate_transition_probabilities_##terms(Pedestrian current_pedestrian) \
+    { \
+        calculate_transition_probabilities(current_pedestrian, terms); \
+    }
+
+typedef void (*Transition_Variant)(Pedestrian current_pedestrian);
+
+DEFINE_TRANSITION_VARIANT(0)
+DEFINE_TRANSITION_VARIANT(1)
+DEFINE_TRANSITION_VARIANT(2)
+DEFINE_TRANSITION_VARIANT(3)
+DEFINE_TRANSITION_VARIANT(4)
+DEFINE_TRANSITION_VARIANT(5)
+DEFINE_TRANSITION_VARIANT(6)
+DEFINE_TRANSITION_VARIANT(7)
+DEFINE_TRANSITION_VARIANT(8)
+DEFINE_TRANSITION_VARIANT(9)
+DEFINE_TRANSITION_VARIANT(10)
+DEFINE_TRANSITION_VARIANT(11)
+DEFINE_TRANSITION_VARIANT(12)
+DEFINE_TRANSITION_VARIANT(13)
+DEFINE_TRANSITION_VARIANT(14)
+DEFINE_TRANSITION_VARIANT(15)
+
+// The variants, indexed by their terms.
+static const Transition_Variant transition_variants[ALL_TRANSITION_TERMS + 1] = {
+    calculate_transition_probabilities_0, calculate_transition_probabilities_1, calculate_transition_probabilities_2, calculate_transition_probabilities_3,
+    calculate_transition_probabilities_4, calculate_transition_probabilities_5, calculate_transition_probabilities_6, calculate_transition_probabilities_7,
+    calculate_transition_probabilities_8, calculate_transition_probabilities_9, calculate_transition_probabilities_10, calculate_transition_probabilities_11,
+    calculate_transition_probabilities_12, calculate_transition_probabilities_13, calculate_transition_probabilities_14, calculate_transition_probabilities_15
+};
+
+static Transition_Variant transition_variant = calculate_transition_probabilities_15; // Chosen by select_movement_kernels.
+static bool is_fire_possible = true; // False when there is no fire in the environment, so no pedestrian can die.
+static bool is_conflict_denial_possible = true; // False when mu is 0, so the movement of the pedestrians in a conflict is never denied.
+
 /**
  * Inserts a specified number of pedestrians at random locations within the environment.
  * 
- * @note This function does not handle cases where there is insufficient space to insert all pedestrians.
+ * @note The locations are drawn by a partial Fisher-Yates shuffle of the insertion cells of the walkable graph, so each pedestrian
+ * is inserted in a cell drawn uniformly among those still empty. The shuffle runs on a copy of all the insertion cells and the
+ * grids are cleared first, so each call takes time linear in the number of cells of the environment, however few pedestrians
+ * are inserted.
  * 
  * @param num_pedestrians_to_insert Number of pedestrians to insert in the environment.
  * @return Function_Status: FAILURE (0) or SUCCESS (1).
@@ -58,54 +109,68 @@ Function_Status insert_pedestrians_at_random(int num_pedestrians_to_insert)
 
     if(fill_integer_grid(pedestrian_position_grid, cli_args.global_line_number, cli_args.global_column_number, 0) == FAILURE)
         return FAILURE;
+    clear_cell_state_flags(cell_state_grid, OCCUPIED_STATE);
 
-    for(int p_index = 0; p_index < num_pedestrians_to_insert; p_index++)
+    if(num_pedestrians_to_insert > walkable_graph.num_insertion_cells)
     {
+        fprintf(stderr, "There is not enough empty space to accommodate the specified number of pedestrians.\n");
+        return FAILURE;
+    }
 
-        int line = (int) rand_within_limits(1, cli_args.global_line_number - 1);
-        int column = (int) rand_within_limits(1, cli_args.global_column_number - 1);
-        // If any of the drawn number equals the final number of the interval, the coordinates will correspond to a cell occupied by a wall or door. These cases are handled by the is_cell_empty function call bellow.
+    // The shuffle is done on a copy, so the cells drawn by a simulation don't depend on those of the previous ones.
+    int *insertion_cells = malloc(sizeof(int) * walkable_graph.num_insertion_cells);
+    if(insertion_cells == NULL)
+    {
+        fprintf(stderr, "Failure in the allocation of the insertion cells (insert_pedestrians_at_random).\n");
+        return FAILURE;
+    }
+    memcpy(insertion_cells, walkable_graph.insertion_cells, sizeof(int) * walkable_graph.num_insertion_cells);
 
-        // If the cell at the draw coordinates is empty, the pedestrian is immediately inserted there. But, if its not, the pedestrian will be place in the next available empty cell.
-        // If no empty cell is found when the scan reaches the bottom right of the environment, the search will restart at the top left.
+    int num_drawn_cells = 0; // The cells already drawn are the first ones of the copy.
+    for(int p_index = 0; p_index < num_pedestrians_to_insert; p_index++)
+    {
+        Location empty_cell = {-1, -1};
 
-        bool next_pedestrian = false; // Indicates if the pedestrian has already been inserted and that the for loops bellow should end.  
-        bool already_looping = false; // Indicates if the search for an empty cell has already looped around.
-        for(; line < cli_args.global_line_number - 1; line++)
+        // Cells with fire at the start of the simulation aren't empty and are discarded as they are drawn.
+        while(num_drawn_cells < walkable_graph.num_insertion_cells)
         {
-            for(; column < cli_args.global_column_number - 1; column++)
-            {       
-                if(is_cell_empty((Location) {line, column}) == true)
-                {
-                    if( add_new_pedestrian((Location) {line, column}) == FAILURE)
-                        return FAILURE;
-
-                    pedestrian_position_grid[line][column] = pedestrian_set.list[pedestrian_set.num_pedestrians - 1]->id;
-
-                    next_pedestrian = true;
-                    break;
-                }
-            }
-
-            if(next_pedestrian)
+            int remaining_cells = walkable_graph.num_insertion_cells - num_drawn_cells;
+            int drawn_index = (int) rand_within_limits(0, remaining_cells);
+            if(drawn_index >= remaining_cells) // When the draw equals the end of the interval.
+                drawn_index = remaining_cells - 1;
+            drawn_index += num_drawn_cells;
+
+            int drawn_cell = insertion_cells[drawn_index];
+            insertion_cells[drawn_index] = insertion_cells[num_drawn_cells];
+            insertion_cells[num_drawn_cells] = drawn_cell;
+            num_drawn_cells++;
+
+            if(is_cell_empty(walkable_graph.cells[drawn_cell]))
+            {
+                empty_cell = walkable_graph.cells[drawn_cell];
                 break;
+            }
+        }
 
-            column = 1;
+        if(empty_cell.lin == -1)
+        {
+            fprintf(stderr, "There is not enough empty space to accommodate the specified number of pedestrians.\n");
+            free(insertion_cells);
+            return FAILURE;
+        }
 
-            if(line + 1 == cli_args.global_line_number - 1)
-            {
-                if(already_looping)
-                {
-                    fprintf(stderr, "There is not enough empty space to accommodate the specified number of pedestrians.\n");
-                    return FAILURE;
-                }
-                
-                line = 1; // From the draw cell until the end of the environment there is no empty cell, so is necessary to loop around.
-                already_looping = true;
-            }
+        if( add_new_pedestrian(empty_cell) == FAILURE)
+        {
+            free(insertion_cells);
+            return FAILURE;
         }
+
+        pedestrian_position_grid[empty_cell.lin][empty_cell.col] = pedestrian_set.list[pedestrian_set.num_pedestrians - 1]->id;
+        cell_state_grid[empty_cell.lin][empty_cell.col] |= OCCUPIED_STATE;
     }
 
+    free(insertion_cells);
+
     return SUCCESS;
 }
 
@@ -126,21 +191,25 @@ Function_Status add_new_pedestrian(Location ped_coordinates)
         return FAILURE;
     }
 
-    pedestrian_set.num_pedestrians += 1;
-    pedestrian_set.list = realloc(pedestrian_set.list, sizeof(struct pedestrian) * pedestrian_set.num_pedestrians);
-    if(pedestrian_set.list == NULL)
+    if(pedestrian_set.num_pedestrians == pedestrian_set.list_capacity)
     {
-        fprintf(stderr,"Failure in the realloc of the pedestrian_set list.\n");
-        return FAILURE;
+        pedestrian_set.list_capacity = pedestrian_set.list_capacity > 0 ? 2 * pedestrian_set.list_capacity : 16;
+        pedestrian_set.list = realloc(pedestrian_set.list, sizeof(Pedestrian) * pedestrian_set.list_capacity);
+        if(pedestrian_set.list == NULL)
+        {
+            fprintf(stderr,"Failure in the realloc of the pedestrian_set list.\n");
+            return FAILURE;
+        }
     }
 
+    pedestrian_set.num_pedestrians += 1;
+
     new_pedestrian->id = pedestrian_set.num_pedestrians;
     pedestrian_set.list[pedestrian_set.num_pedestrians - 1] = new_pedestrian;
 
     return SUCCESS;
 }
 
-
 /**
  * Deallocate the pedestrian_set list and reset the number of pedestrians.
 */
@@ -153,6 +222,35 @@ void deallocate_pedestrians()
     pedestrian_set.list = NULL;
 
     pedestrian_set.num_pedestrians = 0;
+    pedestrian_set.list_capacity = 0;
+}
+
+/**
+ * Selects the variants of the movement kernels for the current values of the constants. The terms of the transition probabilities
+ * that can't change them are compiled out of the variant used: the dynamic floor field when kd is 0, the fire floor field when
+ * there is no fire or kf is 0 and the inertia when omega is 1. Without fire, the fire-free variants also skip the vision of the
+ * exits (whose lines of sight are only blocked by fire, so the static floor field is always used), the verification of the
+ * cells with fire or in danger and of the dead pedestrians. When mu is 0, no draw is made to deny the movement of the pedestrians
+ * in a conflict.
+ *
+ * @note Must be called whenever the constants change, before the simulation runs (which run_single_simulation does).
+*/
+void select_movement_kernels()
+{
+    int terms = 0;
+
+    if(cli_args.kd != 0)
+        terms |= DYNAMIC_FIELD_TERM;
+    if(cli_args.fire_is_present)
+        terms |= FIRE_TERMS;
+    if(cli_args.fire_is_present && cli_args.kf != 0)
+        terms |= FIRE_FIELD_TERM;
+    if(cli_args.omega != 1)
+        terms |= INERTIA_TERM;
+
+    transition_variant = transition_variants[terms];
+    is_fire_possible = cli_args.fire_is_present;
+    is_conflict_denial_possible = cli_args.mu != 0;
 }
 
 /**
@@ -164,7 +262,7 @@ void evaluate_pedestrians_movements()
     {
         Pedestrian current_pedestrian = pedestrian_set.list[p_index];
 
-        if(is_pedestrian_dead(current_pedestrian))
+        if(is_fire_possible && is_pedestrian_dead(current_pedestrian))
         {
             current_pedestrian->state = DEAD;
             pedestrian_set.num_dead_pedestrians++;
@@ -173,7 +271,7 @@ void evaluate_pedestrians_movements()
         if(current_pedestrian->state != MOVING)
             continue;
 
-        calculate_transition_probabilities(current_pedestrian);
+        transition_variant(current_pedestrian);
         Location destination_cell = transition_selection(current_pedestrian);
 
         current_pedestrian->target = destination_cell;
@@ -283,7 +381,7 @@ Function_Status solve_pedestrian_conflicts(Cell_Conflict pedestrian_conflicts, i
     {
         Cell_Conflict current_conflict = &(pedestrian_conflicts[conflict_index]);
 
-        if(probability_test(cli_args.mu)) // The movement to all pedestrian in the conflict has been denied
+        if(is_conflict_denial_possible && probability_test(cli_args.mu)) // The movement to all pedestrian in the conflict has been denied
             random_result = -1; // Since random_result has been assigned as -1, all pedestrian will have their states changed to STOPPED.
         else
         {
@@ -348,7 +446,7 @@ void apply_pedestrian_movement()
             current_pedestrian->previous = current_pedestrian->current;
             current_pedestrian->current = current_pedestrian->target;
 
-            if(exits_only_grid[current_pedestrian->current.lin][current_pedestrian->current.col] == EXIT_CELL)
+            if(cell_state_grid[current_pedestrian->current.lin][current_pedestrian->current.col] & EXIT_STATE)
             {
                 current_pedestrian->state = cli_args.immediate_exit ? GOT_OUT : LEAVING; 
                 // Leaving means the pedestrian will remain for a timestep before being removed from the environment.
@@ -361,6 +459,24 @@ void apply_pedestrian_movement()
     }
 }
 
+/**
+ * Counts the pedestrians that are still in the environment (neither out nor dead).
+ * @return The number of pedestrians in the environment.
+*/
+int count_pedestrians_in_environment()
+{
+    int num_pedestrians = 0;
+
+    for(int p_index = 0; p_index < pedestrian_set.num_pedestrians; p_index++)
+    {
+        Pedestrian current_pedestrian = pedestrian_set.list[p_index];
+        if(current_pedestrian->state != GOT_OUT && current_pedestrian->state != DEAD)
+            num_pedestrians++;
+    }
+
+    return num_pedestrians;
+}
+
 /**
  * Verifies if all alive pedestrians have exited.
  * @return bool, where True indicates that the environment is empty (no alive pedestrians) and False otherwise.
@@ -378,11 +494,13 @@ bool is_environment_empty()
 }
 
 /**
- * Reset the pedestrian_position_grid and update it with the current position of all pedestrians still in the environment.
+ * Reset the pedestrian_position_grid and update it with the current position of all pedestrians still in the environment,
+ * which are also marked with OCCUPIED_STATE in the cell_state_grid.
 */
 void update_pedestrian_position_grid()
 {
     fill_integer_grid(pedestrian_position_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
+    clear_cell_state_flags(cell_state_grid, OCCUPIED_STATE);
 
     for(int p_index = 0; p_index < pedestrian_set.num_pedestrians; p_index++)
     {
@@ -392,6 +510,7 @@ void update_pedestrian_position_grid()
             continue;
 
         pedestrian_position_grid[current_pedestrian->current.lin][current_pedestrian->current.col] = current_pedestrian->id;
+        cell_state_grid[current_pedestrian->current.lin][current_pedestrian->current.col] |= OCCUPIED_STATE;
         heatmap_grid[current_pedestrian->current.lin][current_pedestrian->current.col]++;
     }
 }
@@ -416,6 +535,7 @@ void reset_pedestrian_state()
 void reset_pedestrians_structures()
 {
     fill_integer_grid(pedestrian_position_grid, cli_args.global_line_number, cli_args.global_column_number, 0);
+    clear_cell_state_flags(cell_state_grid, OCCUPIED_STATE);
     
     for(int p_index = 0; p_index < pedestrian_set.num_pedestrians; p_index++)
     {
@@ -425,7 +545,58 @@ void reset_pedestrians_structures()
         current_pedestrian->current = current_pedestrian->origin;
         current_pedestrian->state = MOVING;
         pedestrian_position_grid[current_pedestrian->current.lin][current_pedestrian->current.col] = current_pedestrian->id;
+        cell_state_grid[current_pedestrian->current.lin][current_pedestrian->current.col] |= OCCUPIED_STATE;
+    }
+}
+
+/**
+ * Verify if the given pedestrian has the vision of any non-blocked exit cell obstructed. If true, a static floor field without the affected exit cells is calculated and stored in the aux_static_grid.
+ * 
+ * @param current_pedestrian The pedestrian whose vision will be evaluated.
+ * @return A bool, indicating if the pedestrian's view of any exit cell is obstructed (true) or not (false).
+ */
+bool evaluate_pedestrian_vision(Pedestrian current_pedestrian)
+{
+    Location current_loc = current_pedestrian->current;
+    Location *exit_cell_coordinates = NULL;
+    int num_exit_cells = 0;
+
+    bool vision_blocked = false; // Indicates whether the pedestrian's view of ANY exit is obstructed.
+
+    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++) 
+    {
+        Exit current_exit = exits_set.list[exit_index];
+
+        if(current_exit->is_blocked_by_fire)
+            continue;
+
+        for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
+        {
+            Location current_cell = current_exit->coordinates[cell_index];
+
+            if(is_vision_blocked(current_loc, current_cell))
+            {
+                vision_blocked = true;
+                continue;
+            }
+            
+            exit_cell_coordinates = realloc(exit_cell_coordinates, sizeof(Location) * (num_exit_cells + 1));
+            if(exit_cell_coordinates == NULL)
+            {
+                fprintf(stderr, "Failure in the realloc of the exit_cells_coordinates list (evaluate_pedestrian_vision).\n");
+                return NULL;
+            }
+
+            exit_cell_coordinates[num_exit_cells] = current_cell;
+            num_exit_cells++;
+        }
     }
+
+    calculate_zheng_static_field(exit_cell_coordinates, num_exit_cells, exits_set.aux_static_grid);
+
+    free(exit_cell_coordinates);
+
+    return vision_blocked;
 }
 
 /* ---------------- ---------------- ---------------- ---------------- ---------------- */
@@ -459,33 +630,50 @@ static Pedestrian create_pedestrian(Location ped_coordinates)
 /**
  * Calculates the transition probabilities for the neighborhood of the provided pedestrian.
  * 
+ * @note Always inlined, with constant terms, in the variants defined by DEFINE_TRANSITION_VARIANT, so the terms left out
+ * are removed by the compiler. A term left out must not change the probabilities (see select_movement_kernels).
+ * 
  * @param current_pedestrian Pedestrian for which the transition probabilities will be calculated.
+ * @param terms The terms of the probabilities that are calculated (DYNAMIC_FIELD_TERM, FIRE_FIELD_TERM, INERTIA_TERM and FIRE_TERMS).
  */
-static void calculate_transition_probabilities(Pedestrian current_pedestrian)
+static inline void calculate_transition_probabilities(Pedestrian current_pedestrian, int terms)
 {
     double alpha = 1;
 
     double normalization_value = 0; // The N value in the formula
 
-    Double_Grid static_field = evaluate_pedestrian_vision(current_pedestrian) ? exits_set.aux_static_grid : exits_set.static_floor_field;
+    Field_Grid static_field = exits_set.static_floor_field;
+    Field_Value static_field_normalizer = exits_set.static_field_normalizer; // The static floor field is stored unnormalized (see compose_zheng_static_field).
+    if(terms & FIRE_TERMS)
+    {
+        long long vision_start = start_profile_phase();
+        if(evaluate_pedestrian_vision(current_pedestrian))
+        {
+            static_field = exits_set.aux_static_grid; // Already normalized.
+            static_field_normalizer = 1;
+        }
+        end_profile_phase(PHASE_VISION, vision_start);
+    }
     // Necessário calcular uma grid de distâncias
     // Ou calcular apenas as distancias das celulas na vizinhança
 
+    // The neighborhood is taken from the walkable graph, whose cells are those where the static field isn't IMPASSABLE_OBJECT.
+    int cell_index = walkable_graph.index_grid[current_pedestrian->current.lin][current_pedestrian->current.col];
+
     for(int i = 0; i < 3; i++)
     {
         for(int j = 0; j < 3; j++)
         {
             if(i != 1 && j != 1) // Ignore the diagonals, since all their probabilities is 0.
+            {
+                current_pedestrian->probabilities[i][j] = 0; // Discards the result of the previous normalization, which may be NaN.
                 continue;
+            }
 
-            int lin = current_pedestrian->current.lin + i - 1;
-            int col = current_pedestrian->current.col + j - 1;
+            // The von Neumann neighbors are stored in the order of the (i,j) positions: up, left, right and down.
+            int neighbor = (i == 1 && j == 1) ? cell_index : walkable_graph.von_neumann_neighbors[4 * cell_index + (3 * i + j - 1) / 2];
 
-            if(! is_within_grid_lines(lin) || 
-                ! is_within_grid_columns(col) ||
-                is_cell_with_fire((Location) {lin, col}) ||
-                static_field[lin][col] == IMPASSABLE_OBJECT ||
-                risky_cells_grid[lin][col] == DANGER_CELL) 
+            if(neighbor == NO_NEIGHBOR || ((terms & FIRE_TERMS) && (cell_state_grid[0][walkable_graph.offsets[neighbor]] & (FIRE_STATE | DANGER_STATE)))) 
             {
                 // Verifying fire and obstacles before performing any part of the calculation helps avoid unnecessary computations.
                 current_pedestrian->probabilities[i][j] = 0;
@@ -493,16 +681,20 @@ static void calculate_transition_probabilities(Pedestrian current_pedestrian)
                 continue;
             }
 
+            int offset = walkable_graph.offsets[neighbor];
+            uint8_t cell_state = cell_state_grid[0][offset];
+
             // Static floor field
-            current_pedestrian->probabilities[i][j] = exp(cli_args.ks * static_field[lin][col]);
+            current_pedestrian->probabilities[i][j] = exp(cli_args.ks * (static_field[0][offset] / static_field_normalizer));
 
             // Dynamic floor field
-            current_pedestrian->probabilities[i][j] *= exp(cli_args.kd * exits_set.dynamic_floor_field[lin][col]); 
+            if(terms & DYNAMIC_FIELD_TERM)
+                current_pedestrian->probabilities[i][j] *= exp(cli_args.kd * exits_set.dynamic_floor_field[0][offset]); 
 
             // Fire floor field
-            if(risky_cells_grid[lin][col] == NON_RISKY_CELLS) // If its a risky cell (danger cells have already been verified out) the pedestrian ignores the influence of the fire and this code isn't run.
+            if((terms & FIRE_FIELD_TERM) && ! (cell_state & RISKY_STATE)) // If its a risky cell (danger cells have already been verified out) the pedestrian ignores the influence of the fire and this code isn't run.
             {
-                if(exits_set.distance_to_exits_grid[lin][col] < cli_args.risk_distance)
+                if(exits_set.distance_to_exits_grid[0][offset] < cli_args.risk_distance)
                     alpha = cli_args.fire_alpha;
                 else
                     alpha = 1;
@@ -511,13 +703,13 @@ static void calculate_transition_probabilities(Pedestrian current_pedestrian)
             }
 
             if(! (i == 1 && j == 1)) // Ignores when it is the pedestrian's cell.
-                current_pedestrian->probabilities[i][j] *= pedestrian_position_grid[lin][col] > 0 ? 0 : 1; // Multiply by 0 if cell is occupied
+                current_pedestrian->probabilities[i][j] *= (cell_state & OCCUPIED_STATE) ? 0 : 1; // Multiply by 0 if cell is occupied
 
             normalization_value += current_pedestrian->probabilities[i][j];  
         }
     }
 
-    if( !are_same_coordinates(current_pedestrian->previous, current_pedestrian->current))
+    if((terms & INERTIA_TERM) && !are_same_coordinates(current_pedestrian->previous, current_pedestrian->current))
     {
         // If the pedestrian has moved on the previous timestep
         Location inertia_mask = calculate_inertia_mask(current_pedestrian->previous, current_pedestrian->current);
@@ -539,20 +731,6 @@ static void calculate_transition_probabilities(Pedestrian current_pedestrian)
             current_pedestrian->probabilities[i][j] *= normalization_value;
         }
     }
-
-    if(current_pedestrian->id == 8)
-    {
-        printf("%d %d\n", current_pedestrian->current.lin, current_pedestrian->current.col);
-        for(int i = 0; i < 3; i++)
-        {
-            for(int j = 0; j < 3; j++)
-            {
-                printf("%.3lf ", current_pedestrian->probabilities[i][j]);
-            }
-            printf("\n");
-        }
-        fflush(stdout);
-    }
 }
 
 /**
@@ -605,56 +783,6 @@ static Location calculate_inertia_mask(Location previous, Location current)
     return (Location) {current.lin - previous.lin, current.col - previous.col};
 }
 
-/**
- * Verify if the given pedestrian has the vision of any non-blocked exit cell obstructed. If true, a static floor field without the affected exit cells is calculated and stored in the aux_static_grid.
- * 
- * @param current_pedestrian The pedestrian whose vision will be evaluated.
- * @return A bool, indicating if the pedestrian's view of any exit cell is obstructed (true) or not (false).
- */
-static bool evaluate_pedestrian_vision(Pedestrian current_pedestrian)
-{
-    Location current_loc = current_pedestrian->current;
-    Location *exit_cell_coordinates = NULL;
-    int num_exit_cells = 0;
-
-    bool vision_blocked = false; // Indicates whether the pedestrian's view of ANY exit is obstructed.
-
-    for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++) 
-    {
-        Exit current_exit = exits_set.list[exit_index];
-
-        if(current_exit->is_blocked_by_fire)
-            continue;
-
-        for(int cell_index = 0; cell_index < current_exit->width; cell_index++)
-        {
-            Location current_cell = current_exit->coordinates[cell_index];
-
-            if(is_vision_blocked(current_loc, current_cell))
-            {
-                vision_blocked = true;
-                continue;
-            }
-            
-            exit_cell_coordinates = realloc(exit_cell_coordinates, sizeof(Location) * (num_exit_cells + 1));
-            if(exit_cell_coordinates == NULL)
-            {
-                fprintf(stderr, "Failure in the realloc of the exit_cells_coordinates list (evaluate_pedestrian_vision).\n");
-                return NULL;
-            }
-
-            exit_cell_coordinates[num_exit_cells] = current_cell;
-            num_exit_cells++;
-        }
-    }
-
-    calculate_zheng_static_field(exit_cell_coordinates, num_exit_cells, exits_set.aux_static_grid);
-
-    free(exit_cell_coordinates);
-
-    return vision_blocked;
-}
-
 /**
  * Verifies if the pedestrian in the origin location doesn't have a clean vision of the exit at destination.
  * 
@@ -752,7 +880,5 @@ static bool is_vision_blocked(Location origin, Location destination)
  */
 static bool is_pedestrian_dead(Pedestrian current_pedestrian)
 {
-    Location current_location = current_pedestrian->current;
-
-    return fire_grid[current_location.lin][current_location.col] == FIRE_CELL;
+    return is_cell_with_fire(current_pedestrian->current);
 }
\ No newline at end of file
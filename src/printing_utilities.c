@@ -10,12 +10,15 @@
 #include<time.h>
 
 #include"../headers/exit.h"
+#include"../headers/heatmap.h"
 #include"../headers/fire_dynamics.h"
 #include"../headers/pedestrian.h"
 #include"../headers/cli_processing.h"
 #include"../headers/printing_utilities.h"
 #include"../headers/shared_resources.h"
 
+static void print_heatmap_grid(FILE *output_stream, Int_Grid grid);
+
 /**
  * Print the command received by CLI on the provided stream.
  * 
@@ -33,7 +36,7 @@ void print_full_command(FILE *output_stream)
 }
 
 /**
- * Print the heatmap grid on the provided stream.
+ * Print the heatmap grid on the provided stream. If the heatmap is split in timestep windows, each window is printed, preceded by its timestep range.
  * 
  * @note The value of each position of the grid is divided by the number of simulations in order to achieve the mean of all simulations.
  * 
@@ -43,13 +46,18 @@ void print_heatmap(FILE *output_stream)
 {
 	if(output_stream != NULL)
 	{
-		for(int i = 0; i < cli_args.global_line_number; i++){
-			for(int j = 0; j < cli_args.global_column_number; j++)
-				fprintf(output_stream, "%.2lf ", (double) heatmap_grid[i][j] / (double) cli_args.num_simulations);
+		if(cli_args.heatmap_window <= 0)
+		{
+			print_heatmap_grid(output_stream, heatmap_grid);
+			return;
+		}
 
-			fprintf(output_stream,"\n");
+		for(int window_index = 0; window_index < num_heatmap_windows; window_index++)
+		{
+			fprintf(output_stream, "Window %d (timesteps %d-%d):\n", window_index, 
+									window_index * cli_args.heatmap_window, (window_index + 1) * cli_args.heatmap_window);
+			print_heatmap_grid(output_stream, heatmap_windows[window_index]);
 		}
-		fprintf(output_stream,"\n");
 	}
 	else
 		fprintf(stderr, "No valid stream was provided at print_heatmap.\n");
@@ -76,14 +84,14 @@ void print_complete_environment(FILE *output_stream, int simulation_number, int
 			{
 				if(pedestrian_position_grid[i][j] != 0)
 				{
-					if(fire_grid[i][j] == FIRE_CELL)
+					if(is_cell_with_fire((Location) {i,j}))
 						fprintf(output_stream, "🪦");
 					else
 						fprintf(output_stream,"👤");
 				}
-				else if(fire_grid[i][j] == FIRE_CELL)
+				else if(is_cell_with_fire((Location) {i,j}))
 					fprintf(output_stream, "🔥");
-				else if(exits_only_grid[i][j] == EXIT_CELL)
+				else if(cell_state_grid[i][j] & EXIT_STATE)
 					fprintf(output_stream,"🚪");
 				else if(obstacle_grid[i][j] == IMPASSABLE_OBJECT)
 					fprintf(output_stream,"🧱");
@@ -115,14 +123,14 @@ void print_int_grid(FILE *output_stream, Int_Grid int_grid)
 }
 
 /**
- * Prints the double_grid (using the provided precision) to the specified stream.
+ * Prints the field_grid (using the provided precision) to the specified stream.
  * 
  * @param output_stream Stream where the data will be written.
- * @param double_grid Double_Grid to be printed.
+ * @param field_grid Field_Grid to be printed.
  * @param precision Precision of the printed value.
  * 
 */
-void print_double_grid(FILE *output_stream, Double_Grid double_grid, int precision)
+void print_field_grid(FILE *output_stream, Field_Grid field_grid, int precision)
 {
 	if(precision < 0)
 		precision = 0;
@@ -130,10 +138,10 @@ void print_double_grid(FILE *output_stream, Double_Grid double_grid, int precisi
 	for(int i = 0; i < cli_args.global_line_number; i++){
 		for(int j = 0; j < cli_args.global_column_number; j++)
 
-			if(double_grid[i][j] < 0)
-				fprintf(output_stream, "%*.0f ", 2 + precision, double_grid[i][j]);
+			if(field_grid[i][j] < 0)
+				fprintf(output_stream, "%*.0f ", 2 + precision, field_grid[i][j]);
 			else
-				fprintf(output_stream, "%5.*lf ", precision, double_grid[i][j]);
+				fprintf(output_stream, "%5.*lf ", precision, field_grid[i][j]);
 
 		printf("\n\n");
 	}
@@ -141,17 +149,17 @@ void print_double_grid(FILE *output_stream, Double_Grid double_grid, int precisi
 }
 
 /**
- * Prints the double_grid multiplied by the given value (using the provided precision) to the specified stream.
+ * Prints the field_grid multiplied by the given value (using the provided precision) to the specified stream.
  * 
  * @note The multiplication doesn't alter the values within the grid. The operation is external to them.
  * 
  * @param output_stream Stream where the data will be written.
- * @param double_grid Double_Grid to be printed.
+ * @param field_grid Field_Grid to be printed.
  * @param precision Precision of the printed value.
  * @param value The value that will be multiplied to the grid.
  * 
 */
-void multiply_and_print_double_grid(FILE *output_stream, Double_Grid double_grid, int precision, double value)
+void multiply_and_print_field_grid(FILE *output_stream, Field_Grid field_grid, int precision, double value)
 {
 	if(precision < 0)
 		precision = 0;
@@ -159,10 +167,10 @@ void multiply_and_print_double_grid(FILE *output_stream, Double_Grid double_grid
 	for(int i = 0; i < cli_args.global_line_number; i++){
 		for(int j = 0; j < cli_args.global_column_number; j++)
 
-			if(double_grid[i][j] < 0)
-				fprintf(output_stream, "%*.0f ", 2 + precision, value * double_grid[i][j]);
+			if(field_grid[i][j] < 0)
+				fprintf(output_stream, "%*.0f ", 2 + precision, value * field_grid[i][j]);
 			else
-				fprintf(output_stream, "%5.*lf ", precision, value * double_grid[i][j]);
+				fprintf(output_stream, "%5.*lf ", precision, value * field_grid[i][j]);
 
 		printf("\n\n");
 	}
@@ -248,3 +256,24 @@ void print_placeholder(FILE *stream, int placeholder)
 	}
 	fprintf(stream, "\n");
 }
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Print a single heatmap grid, with each position divided by the number of simulations, on the provided stream.
+ * 
+ * @param output_stream Stream where the data will be written.
+ * @param grid The heatmap grid to be printed.
+*/
+static void print_heatmap_grid(FILE *output_stream, Int_Grid grid)
+{
+	for(int i = 0; i < cli_args.global_line_number; i++){
+		for(int j = 0; j < cli_args.global_column_number; j++)
+			fprintf(output_stream, "%.2lf ", (double) grid[i][j] / (double) cli_args.num_simulations);
+
+		fprintf(output_stream,"\n");
+	}
+	fprintf(output_stream,"\n");
+}
@@ -0,0 +1,186 @@
+/*
+   File: profiling.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the per-phase timing of the timestep loop (enabled with --profile). Each process accumulates the time spent in every phase in private counters, which are added, at the end of each simulation, to counters shared with the workers. After each simulation set, a summary table is printed and the raw counts are appended to a CSV file.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<sys/mman.h>
+
+#include"../headers/profiling.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+typedef struct{
+    long long calls[NUM_PROFILE_PHASES];
+    long long nanoseconds[NUM_PROFILE_PHASES];
+}Phase_Counters;
+
+static const char *phase_names[NUM_PROFILE_PHASES] = {
+    "vision", "transition_probabilities", "conflicts", "movement", "grid_update", "diffusion", "fire_propagation", "static_field"
+};
+
+// The vision is evaluated within the calculation of the transition probabilities, so its time is subtracted from them.
+static const int phase_parents[NUM_PROFILE_PHASES] = {
+    PHASE_TRANSITION_PROBABILITIES, -1, -1, -1, -1, -1, -1, -1
+};
+
+static const char *profile_path = "output/";
+
+static Phase_Counters local_counters; // Counts of the simulation in progress, private to each process.
+static Phase_Counters *shared_counters = NULL; // Counts of the simulation set in progress. Only allocated with --profile.
+static FILE *profile_file = NULL;
+
+/**
+ * Allocates the profile counters, in memory shared with the workers forked afterwards, and creates the CSV file where the raw counts are written.
+ *
+ * @note If this function isn't called, start_profile_phase and end_profile_phase do nothing.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status allocate_profile_counters()
+{
+    char complete_path[300] = "";
+
+    sprintf(complete_path, "%s%s", profile_path, cli_args.profile_filename);
+    profile_file = fopen(complete_path, "w");
+    if(profile_file == NULL)
+    {
+        fprintf(stderr, "It was not possible to open the profile file %s.\n", complete_path);
+        return FAILURE;
+    }
+    fprintf(profile_file, "simulation_set,phase,calls,nanoseconds\n");
+
+    shared_counters = mmap(NULL, sizeof(Phase_Counters), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shared_counters == MAP_FAILED)
+    {
+        perror("Failure to map the memory of the profile counters");
+        shared_counters = NULL;
+        fclose(profile_file);
+        profile_file = NULL;
+        return FAILURE;
+    }
+
+    memset(shared_counters, 0, sizeof(Phase_Counters));
+    memset(&local_counters, 0, sizeof(Phase_Counters));
+
+    return SUCCESS;
+}
+
+/**
+ * Marks the beginning of a phase.
+ *
+ * @return The current time, in nanoseconds, to be given to end_profile_phase, or 0 if profiling is disabled.
+ */
+long long start_profile_phase()
+{
+    if(shared_counters == NULL)
+        return 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ * Marks the end of a phase, adding the time elapsed since start to its counters.
+ *
+ * @param phase The phase that ended.
+ * @param start Value returned by start_profile_phase at the beginning of the phase.
+ */
+void end_profile_phase(Profile_Phase phase, long long start)
+{
+    if(shared_counters == NULL)
+        return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    long long elapsed = now.tv_sec * 1000000000LL + now.tv_nsec - start;
+
+    local_counters.calls[phase]++;
+    local_counters.nanoseconds[phase] += elapsed;
+
+    if(phase_parents[phase] >= 0)
+        local_counters.nanoseconds[phase_parents[phase]] -= elapsed;
+}
+
+/**
+ * Adds the counts of the simulation that ended to the counters of the simulation set, and resets them.
+ *
+ * @note Must be called at the end of every simulation, by the process that ran it.
+ */
+void flush_profile_counters()
+{
+    if(shared_counters == NULL)
+        return;
+
+    for(int phase = 0; phase < NUM_PROFILE_PHASES; phase++)
+    {
+        __atomic_add_fetch(&shared_counters->calls[phase], local_counters.calls[phase], __ATOMIC_RELAXED);
+        __atomic_add_fetch(&shared_counters->nanoseconds[phase], local_counters.nanoseconds[phase], __ATOMIC_RELAXED);
+    }
+
+    memset(&local_counters, 0, sizeof(Phase_Counters));
+}
+
+/**
+ * Prints, on stderr, a table with the time spent in each phase by the simulations of the simulation set, appends the raw
+ * counts to the CSV file and resets the counters for the next simulation set.
+ *
+ * @param simulation_set_index Index of the simulation set.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status report_simulation_set_profile(int simulation_set_index)
+{
+    if(shared_counters == NULL)
+        return SUCCESS;
+
+    long long total_nanoseconds = 0;
+    for(int phase = 0; phase < NUM_PROFILE_PHASES; phase++)
+        total_nanoseconds += shared_counters->nanoseconds[phase];
+
+    fprintf(stderr, "\nProfile of simulation set %d:\n", simulation_set_index + 1);
+    fprintf(stderr, "%-26s %12s %14s %12s %8s\n", "phase", "calls", "total (ms)", "mean (us)", "share");
+    for(int phase = 0; phase < NUM_PROFILE_PHASES; phase++)
+    {
+        long long calls = shared_counters->calls[phase];
+        long long nanoseconds = shared_counters->nanoseconds[phase];
+
+        fprintf(stderr, "%-26s %12lld %14.3f %12.3f %7.2f%%\n", phase_names[phase], calls, nanoseconds / 1E6,
+                calls > 0 ? nanoseconds / 1E3 / calls : 0, total_nanoseconds > 0 ? 100.0 * nanoseconds / total_nanoseconds : 0);
+
+        fprintf(profile_file, "%d,%s,%lld,%lld\n", simulation_set_index + 1, phase_names[phase], calls, nanoseconds);
+    }
+    fprintf(stderr, "%-26s %12s %14.3f\n", "total", "", total_nanoseconds / 1E6);
+
+    memset(shared_counters, 0, sizeof(Phase_Counters));
+
+    if(fflush(profile_file) == EOF)
+    {
+        fprintf(stderr, "Failure while writing the profile file.\n");
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Unmaps the profile counters and closes the CSV file, if profiling is enabled.
+ */
+void deallocate_profile_counters()
+{
+    if(shared_counters != NULL)
+        munmap(shared_counters, sizeof(Phase_Counters));
+
+    if(profile_file != NULL)
+        fclose(profile_file);
+
+    shared_counters = NULL;
+    profile_file = NULL;
+}
@@ -0,0 +1,362 @@
+/*
+   File: set_scheduler.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the scheduler that runs the simulation sets of an auxiliary file (or of --door-combinations) in parallel. Every simulation of every simulation set (set, point of the sweep, replica) is a task of a single run of the worker pool, whose workers steal tasks from each other, so simulation sets of very different costs (inaccessible exits, exits blocked by the fire) keep every worker busy. Each worker loads the simulation sets of its tasks into its own grids, which are reused from set to set. The results are printed in the order, and with the seeds, of the sequential execution.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"../headers/set_scheduler.h"
+#include"../headers/exit.h"
+#include"../headers/door_combinations.h"
+#include"../headers/initialization.h"
+#include"../headers/static_field.h"
+#include"../headers/simulation.h"
+#include"../headers/sweep.h"
+#include"../headers/worker_pool.h"
+#include"../headers/printing_utilities.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+typedef struct{
+    long file_position; // Position of the simulation set in the auxiliary file (not used with --door-combinations).
+    int num_exits;
+    bool is_accessible;
+    int first_seed;
+    int first_task; // Index of the first task of the simulation set, if it is accessible.
+    char *information; // Output of print_simulation_set_information, if --simulation-set-info was given.
+}Planned_Set;
+
+static Function_Status plan_simulation_sets(FILE *auxiliary_file);
+static Function_Status simulation_set_task(int task_index, int *number_timesteps);
+static Function_Status load_simulation_set(int set_index);
+static void release_loaded_set();
+static Function_Status print_finished_sets(int num_finished_tasks, const int *task_results);
+static void deallocate_planned_sets();
+
+static Planned_Set *planned_sets = NULL;
+static int num_planned_sets = 0;
+static int *task_sets = NULL; // Simulation set of each block of num_set_jobs tasks.
+static int num_set_jobs = 0; // Number of simulations of each simulation set.
+
+static FILE *scheduler_output_file = NULL;
+static int simulation_set_total = 0; // Number of simulation sets shown in the execution status.
+static int num_printed_sets = 0;
+
+static FILE *set_auxiliary_file = NULL; // Opened by each process that loads simulation sets from the auxiliary file.
+static int loaded_set = -1; // Simulation set whose exits and fields are loaded in this process.
+
+/**
+ * Verifies if the simulation sets are run by the set scheduler. The workers must be enabled and the results must be known
+ * only at the end of each simulation set: the timesteps output format, without --convergence (whose rounds depend on the
+ * results) and without --profile (which is reported per simulation set).
+ *
+ * @return bool, where True indicates that run_all_simulation_sets must be used, or False otherwise.
+ */
+bool is_set_scheduling_enabled()
+{
+    return are_workers_enabled() && origin_uses_auxiliary_data() &&
+           cli_args.output_format == OUTPUT_TIMESTEPS_COUNT &&
+           cli_args.convergence_tolerance == 0 && ! cli_args.profile;
+}
+
+/**
+ * Runs every simulation set of the auxiliary file (or every door combination), printing the results of each one as soon as it,
+ * and every simulation set before it, is finished.
+ *
+ * @note The simulation sets are first read in order, only to find the inaccessible ones, so every simulation keeps the seed of
+ * the sequential execution (the seeds of inaccessible simulation sets aren't used).
+ *
+ * @param output_file Stream where the results will be written.
+ * @param auxiliary_file File where the simulation sets (or the candidate doors) are stored.
+ * @param simulation_set_quantity Number of simulation sets, shown in the execution status.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status run_all_simulation_sets(FILE *output_file, FILE *auxiliary_file, int simulation_set_quantity)
+{
+    num_set_jobs = count_simulation_set_jobs();
+    scheduler_output_file = output_file;
+    simulation_set_total = simulation_set_quantity;
+    num_printed_sets = 0;
+
+    if(plan_simulation_sets(auxiliary_file) == FAILURE)
+        return FAILURE;
+
+    int num_accessible_sets = 0;
+    for(int set_index = 0; set_index < num_planned_sets; set_index++)
+    {
+        if(! planned_sets[set_index].is_accessible)
+            continue;
+
+        planned_sets[set_index].first_seed = cli_args.seed;
+        planned_sets[set_index].first_task = num_accessible_sets * num_set_jobs;
+        task_sets[num_accessible_sets++] = set_index;
+        cli_args.seed += num_set_jobs;
+    }
+
+    int num_tasks = num_accessible_sets * num_set_jobs;
+    int *task_results = malloc(sizeof(int) * (num_tasks > 0 ? num_tasks : 1));
+    if(task_results == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of simulation results.\n");
+        deallocate_planned_sets();
+        return FAILURE;
+    }
+
+    Function_Status status = run_jobs_with_progress(num_tasks, &simulation_set_task, task_results, &print_finished_sets);
+
+    if(status == SUCCESS)
+        status = print_finished_sets(num_tasks, task_results); // The inaccessible simulation sets at the end have no tasks.
+
+    // The simulation sets are loaded by this process when the tasks aren't divided among workers.
+    release_loaded_set();
+    deallocate_exits_set_fields();
+    if(set_auxiliary_file != NULL)
+        fclose(set_auxiliary_file);
+    set_auxiliary_file = NULL;
+
+    free(task_results);
+    deallocate_planned_sets();
+
+    return status;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Reads every simulation set, storing where it is and whether all of its exits are accessible.
+ *
+ * @note In case of failure, the simulation sets planned so far are deallocated.
+ *
+ * @param auxiliary_file File where the simulation sets (or the candidate doors) are stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status plan_simulation_sets(FILE *auxiliary_file)
+{
+    int capacity = 16;
+    int exit_number = 0;
+
+    planned_sets = malloc(sizeof(Planned_Set) * capacity);
+    if(planned_sets == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of planned simulation sets.\n");
+        return FAILURE;
+    }
+
+    while(true)
+    {
+        Planned_Set current_set = {ftell(auxiliary_file), 0, true, 0, 0, NULL};
+
+        if(cli_args.door_combination_size > 0)
+        {
+            if(get_next_door_combination(&exit_number) == FAILURE)
+            {
+                deallocate_planned_sets();
+                return FAILURE;
+            }
+
+            current_set.is_accessible = check_door_combination_accessibility() == SUCCESS;
+        }
+        else
+        {
+            if(get_next_simulation_set(auxiliary_file, &exit_number) == FAILURE)
+            {
+                deallocate_planned_sets();
+                return FAILURE;
+            }
+
+            for(int exit_index = 0; exit_index < exits_set.num_exits; exit_index++)
+                current_set.is_accessible = current_set.is_accessible && is_exit_accessible(exits_set.list[exit_index]);
+        }
+
+        if(exit_number == 0)
+            break; // All simulation sets were read.
+
+        current_set.num_exits = exits_set.num_exits;
+
+        if(cli_args.show_simulation_set_info)
+        {
+            size_t information_size = 0;
+            FILE *information_stream = open_memstream(&current_set.information, &information_size);
+            if(information_stream == NULL)
+            {
+                perror("Failure to open the stream of the simulation set information");
+                free(current_set.information);
+                deallocate_planned_sets();
+                return FAILURE;
+            }
+
+            print_simulation_set_information(information_stream);
+            fclose(information_stream);
+        }
+
+        if(cli_args.door_combination_size > 0)
+            release_door_combination();
+        else
+            deallocate_exits();
+
+        if(num_planned_sets == capacity)
+        {
+            capacity *= 2;
+            Planned_Set *larger_list = realloc(planned_sets, sizeof(Planned_Set) * capacity);
+            if(larger_list == NULL)
+            {
+                fprintf(stderr, "Failure in the realloc of the list of planned simulation sets.\n");
+                free(current_set.information);
+                deallocate_planned_sets();
+                return FAILURE;
+            }
+            planned_sets = larger_list;
+        }
+
+        planned_sets[num_planned_sets++] = current_set;
+    }
+
+    task_sets = malloc(sizeof(int) * (num_planned_sets > 0 ? num_planned_sets : 1));
+    if(task_sets == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of task simulation sets.\n");
+        deallocate_planned_sets();
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Job function of the set scheduler: runs a single simulation of a simulation set, loading the simulation set first if it
+ * isn't the one loaded in this process.
+ *
+ * @param task_index Index of the task.
+ * @param number_timesteps Pointer to an integer, where the number of timesteps required by the simulation will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status simulation_set_task(int task_index, int *number_timesteps)
+{
+    int set_index = task_sets[task_index / num_set_jobs];
+
+    if(set_index != loaded_set && load_simulation_set(set_index) == FAILURE)
+        return FAILURE;
+
+    return run_simulation_set_job(task_index % num_set_jobs, planned_sets[set_index].first_seed, number_timesteps);
+}
+
+/**
+ * Loads the exits of a simulation set, calculates their static weights (unless they were calculated for --door-combinations)
+ * and prepares the fields shared by its simulations.
+ *
+ * @note The exits set grids are allocated once per process, and only the exits are replaced from one simulation set to the next.
+ *
+ * @param set_index Index of the simulation set.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status load_simulation_set(int set_index)
+{
+    int exit_number = 0;
+
+    release_loaded_set();
+
+    if(cli_args.door_combination_size > 0)
+    {
+        if(get_door_combination(set_index, &exit_number) == FAILURE)
+            return FAILURE;
+    }
+    else
+    {
+        if(set_auxiliary_file == NULL && open_auxiliary_file(&set_auxiliary_file) == FAILURE)
+            return FAILURE;
+
+        if(fseek(set_auxiliary_file, planned_sets[set_index].file_position, SEEK_SET) != 0)
+        {
+            perror("Failure to find a simulation set in the auxiliary file");
+            return FAILURE;
+        }
+
+        if(get_next_simulation_set(set_auxiliary_file, &exit_number) == FAILURE)
+            return FAILURE;
+
+        if(calculate_all_static_weights() != SUCCESS)
+            return FAILURE;
+    }
+
+    if(exits_set.static_floor_field == NULL && allocate_exits_set_fields() == FAILURE)
+        return FAILURE;
+
+    if(prepare_simulation_set() == FAILURE)
+        return FAILURE;
+
+    loaded_set = set_index;
+
+    return SUCCESS;
+}
+
+/**
+ * Removes the exits of the loaded simulation set, if any, keeping the exits set grids.
+ */
+static void release_loaded_set()
+{
+    if(cli_args.door_combination_size > 0)
+        detach_door_combination();
+    else
+        deallocate_exits_list();
+
+    loaded_set = -1;
+}
+
+/**
+ * Progress function of the set scheduler: prints, in order, every simulation set not yet printed whose tasks are all finished.
+ *
+ * @param num_finished_tasks Number of tasks finished, from the first one on.
+ * @param task_results Results of the tasks.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status print_finished_sets(int num_finished_tasks, const int *task_results)
+{
+    for(; num_printed_sets < num_planned_sets; num_printed_sets++)
+    {
+        Planned_Set *current_set = &planned_sets[num_printed_sets];
+
+        if(current_set->is_accessible && current_set->first_task + num_set_jobs > num_finished_tasks)
+            break;
+
+        if(current_set->information != NULL)
+            fputs(current_set->information, scheduler_output_file);
+
+        if(! current_set->is_accessible)
+            print_placeholder(scheduler_output_file, -1);
+        else
+        {
+            if(cli_args.single_exit_flag == true && current_set->num_exits == 1)
+                fprintf(scheduler_output_file, "#1 ");
+
+            if(print_simulation_set_job_results(scheduler_output_file, current_set->first_seed, &task_results[current_set->first_task]) == FAILURE)
+                return FAILURE;
+
+            fprintf(scheduler_output_file, "\n");
+        }
+
+        fflush(scheduler_output_file);
+        print_execution_status(num_printed_sets, simulation_set_total);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Deallocates the list of planned simulation sets.
+ */
+static void deallocate_planned_sets()
+{
+    for(int set_index = 0; set_index < num_planned_sets; set_index++)
+        free(planned_sets[set_index].information);
+
+    free(planned_sets);
+    free(task_sets);
+    planned_sets = NULL;
+    task_sets = NULL;
+    num_planned_sets = 0;
+}
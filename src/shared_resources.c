@@ -139,6 +139,37 @@ int roulette_wheel_selection(double *probability_list, int length, double total_
     return index; // Will reach in case of rounding errors.
 }
 
+/**
+ * Adds a sample to the running mean and variance, using Welford's algorithm.
+ * 
+ * @param statistics The running statistics to be updated.
+ * @param sample The new sample.
+ */
+void update_running_statistics(Running_Statistics *statistics, double sample)
+{
+    statistics->count++;
+
+    double deviation = sample - statistics->mean;
+    statistics->mean += deviation / statistics->count;
+    statistics->sum_squared_deviations += deviation * (sample - statistics->mean);
+}
+
+/**
+ * Calculates the half-width of the 95% confidence interval of the mean, using the normal approximation.
+ * 
+ * @param statistics The running statistics.
+ * @return The half-width, or HUGE_VAL if there are less than two samples.
+ */
+double calculate_confidence_half_width(Running_Statistics *statistics)
+{
+    if(statistics->count < 2)
+        return HUGE_VAL;
+
+    double variance = statistics->sum_squared_deviations / (statistics->count - 1);
+
+    return 1.96 * sqrt(variance / statistics->count);
+}
+
 /**
  * Verifies if a diagonal beginning at origin_cell and ending at origin_cell + coordinate_modifier is valid for crossing 
  * in the given floor field. 
@@ -148,10 +179,10 @@ int roulette_wheel_selection(double *probability_list, int length, double total_
  * @param origin_cell Origin cell coordinates. Represents where a pedestrian is or a cell whose neighborhood is being calculated.
  * @param coordinate_modifier Line and column coordinate modifiers. They are added to the origin cell coordinates, and the final 
  * result represents one of the four diagonal cells in the origin cell's neighborhood.
- * @param floor_field A Double_Grid representing a floor field.
+ * @param floor_field A Field_Grid representing a floor field.
  * @return bool, where True indicates that a diagonal is valid and False otherwise.
  */
-bool is_diagonal_valid(Location origin_cell, Location coordinate_modifier, Double_Grid floor_field)
+bool is_diagonal_valid(Location origin_cell, Location coordinate_modifier, Field_Grid floor_field)
 {
     bool is_horizontal_blocked = false; // Indicates if the horizontal cell in the origin_cell's neighborhood, which is adjacent to origin_cell + coordinate_modifier, is blocked.
     bool is_vertical_blocked = false;// Indicates if the vertical cell in the origin_cell's neighborhood, which is adjacent to origin_cell + coordinate_modifier, is blocked.
@@ -209,28 +240,16 @@ bool is_within_grid_columns(int column_coordinate)
  */
 bool is_cell_empty(Location coordinates)
 {
-    if(pedestrian_position_grid[coordinates.lin][coordinates.col] != 0)
-        return false;
-
-    if(obstacle_grid[coordinates.lin][coordinates.col] != EMPTY_CELL)
-        return false;
-
-    if(exits_only_grid[coordinates.lin][coordinates.col] != EMPTY_CELL)
-        return false;
-
-    if(fire_grid[coordinates.lin][coordinates.col] != EMPTY_CELL)
-        return false;
-
-    return true;
+    return (cell_state_grid[coordinates.lin][coordinates.col] & (OCCUPIED_STATE | WALL_STATE | ANY_EXIT_STATE | FIRE_STATE)) == 0;
 }
 
 /**
- * Verifies if the cell in the given location has a fire.
+ * Verifies if the cell in the given location has a fire, i.e., if it caught fire up to the current fire epoch.
  * 
  * @param coordinates The coordinates of the cell
  * @return bool, where True indicates that the cell has a fire, or False otherwise.
  */
 bool is_cell_with_fire(Location coordinates)
 {
-    return fire_grid[coordinates.lin][coordinates.col] == FIRE_CELL;
+    return cell_state_grid[coordinates.lin][coordinates.col] & FIRE_STATE;
 }
\ No newline at end of file
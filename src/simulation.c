@@ -0,0 +1,362 @@
+/*
+   File: simulation.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the functions that prepare a simulation set, storing the fields shared by all of its simulations, as well as the timestep loop of a single simulation.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<unistd.h>
+#include<sys/mman.h>
+
+#include"../headers/simulation.h"
+#include"../headers/exit.h"
+#include"../headers/pedestrian.h"
+#include"../headers/heatmap.h"
+#include"../headers/initialization.h"
+#include"../headers/cli_processing.h"
+#include"../headers/printing_utilities.h"
+#include"../headers/shared_resources.h"
+#include"../headers/dynamic_field.h"
+#include"../headers/fire_dynamics.h"
+#include"../headers/fire_timeline.h"
+#include"../headers/cell_graph.h"
+#include"../headers/checkpoint.h"
+#include"../headers/profiling.h"
+
+static Function_Status conflict_solving();
+static Function_Status save_checkpoint(int timesteps, bool has_the_fire_spread);
+
+static int number_empty_cells = 0;
+static int checkpoint_seed = 0; // Seed of the simulation that captures the checkpoint requested with --save-checkpoint (the first one run).
+static Simulation_State loaded_checkpoint = NULL; // State where every simulation starts, if --load-checkpoint was given.
+static Run_Statistics *run_statistics = NULL; // Only allocated with --run-statistics. Shared with the workers, which add their simulations to it.
+
+/**
+ * Determines the values, derived from the command line arguments and the loaded environment, that remain unchanged through all simulations.
+ * 
+ * @note Must be called after the environment is loaded or generated.
+ * 
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status initialize_simulation_constants()
+{
+    number_empty_cells = count_number_empty_cells();
+    checkpoint_seed = cli_args.seed;
+
+    return calculate_ignition_epochs();
+}
+
+/**
+ * Computes the fields that depend only on the simulation set (environment, exits and fire) and stores copies of them, in the
+ * fire timeline. Those fields are the same at each spread of the fire in every simulation of the set, whatever the values of the
+ * Kirchner constants or the seed, so each simulation restores them from the copies (see run_single_simulation) instead of recalculating them.
+ * 
+ * @note Must be called once per simulation set, after the exits set fields are allocated and before any simulation is run.
+ * 
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status prepare_simulation_set()
+{
+    if(build_walkable_graph() == FAILURE)
+        return FAILURE;
+
+    if(strcmp(cli_args.load_checkpoint_filename, "") != 0)
+    {
+        if(loaded_checkpoint == NULL)
+        {
+            loaded_checkpoint = read_simulation_state(cli_args.load_checkpoint_filename);
+            if(loaded_checkpoint == NULL)
+                return FAILURE;
+        }
+
+        if(! is_state_compatible(loaded_checkpoint))
+        {
+            fprintf(stderr, "The checkpoint %s was captured in a different environment, with different exits or by a program with another field scalar (FIELDS).\n", cli_args.load_checkpoint_filename);
+            return FAILURE;
+        }
+    }
+
+    return prepare_fire_timeline();
+}
+
+/**
+ * Deallocates the fire timeline of the simulation set and the loaded checkpoint.
+ */
+void deallocate_simulation_set_fields()
+{
+    deallocate_fire_timeline();
+    deallocate_walkable_graph();
+
+    deallocate_simulation_state(loaded_checkpoint);
+    loaded_checkpoint = NULL;
+}
+
+/**
+ * Returns the number of pedestrians to be randomly inserted in each simulation, considering the current pedestrian density.
+ * 
+ * @return The number of pedestrians.
+ */
+int determine_number_of_pedestrians()
+{
+    if(cli_args.use_density == true)
+        return (int) number_empty_cells * cli_args.density;
+
+    return cli_args.total_num_pedestrians;
+}
+
+/**
+ * Runs a single simulation, from the insertion of the pedestrians until the environment is empty.
+ * 
+ * @note prepare_simulation_set must have been called for the current simulation set.
+ * 
+ * @param output_file Stream where the visual output, if selected, will be written.
+ * @param simulation_index Index of the simulation within the simulation set.
+ * @param seed Seed used to initialize the random number generator.
+ * @param number_timesteps Pointer to an integer, where the number of timesteps required by the simulation will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+*/
+Function_Status run_single_simulation(FILE *output_file, int simulation_index, int seed, int *number_timesteps)
+{
+    int fire_spread_interval = (int) ((CELL_LENGTH / cli_args.spread_rate) / TIMESTEP_TIME); // The number of timesteps between consecutive fire spreads.
+                                                                                              // Determined here since the spread rate may be swept.
+    bool is_dynamic_field_used = cli_args.kd != 0; // Otherwise, the dynamic floor field stays zeroed, since it doesn't change the movement.
+    srand(seed);
+
+    select_movement_kernels(); // The constants may have been swept since the last simulation.
+    pedestrian_set.num_dead_pedestrians = 0; // Resets the number of dead pedestrians.
+
+    fill_field_grid(exits_set.dynamic_floor_field, cli_args.global_line_number, cli_args.global_column_number, 0); // Restart the dynamic floor field
+    restore_initial_fire_epoch(); // Restarts the fire grid and the fields calculated by prepare_simulation_set.
+
+    int timesteps = 0;
+    long long pedestrian_steps = 0;
+    bool has_the_fire_spread = false;
+    bool was_checkpoint_saved = false;
+
+    if(loaded_checkpoint != NULL)
+    {
+        if(restore_simulation_state(loaded_checkpoint, &timesteps, &has_the_fire_spread) == FAILURE)
+            return FAILURE;
+
+        srand(seed); // The restored generator is replaced, so each simulation is a different continuation of the checkpoint.
+    }
+    else if(origin_uses_static_pedestrians() == false)
+    {
+        if( insert_pedestrians_at_random(determine_number_of_pedestrians()) == FAILURE)
+            return FAILURE;
+    }
+    
+    if(cli_args.output_format == OUTPUT_VISUALIZATION)
+        print_complete_environment(output_file, simulation_index, timesteps);
+
+    while(is_environment_empty() == false)
+    {
+        long long phase_start = 0;
+
+        if(has_the_fire_spread) // The fire only spreads when it is already present in the environment, making the fire presence check unnecessary.
+        {
+            phase_start = start_profile_phase();
+            if(update_fields_after_fire_spread() == FAILURE)
+                return FAILURE;
+            end_profile_phase(PHASE_STATIC_FIELD, phase_start);
+
+            has_the_fire_spread = false;
+        }
+
+        if(run_statistics != NULL)
+            pedestrian_steps += count_pedestrians_in_environment();
+
+        if(cli_args.show_debug_information)
+        {
+            printf("\nTimestep %d.\n", timesteps + 1);
+            print_int_grid(stdout, pedestrian_position_grid);
+        }
+
+        if(cli_args.show_debug_information)
+            print_field_grid(stdout, exits_set.dynamic_floor_field, 3);
+
+        phase_start = start_profile_phase();
+        evaluate_pedestrians_movements();
+        end_profile_phase(PHASE_TRANSITION_PROBABILITIES, phase_start);
+
+        phase_start = start_profile_phase();
+        if(conflict_solving() == FAILURE)
+            return FAILURE;
+        end_profile_phase(PHASE_CONFLICTS, phase_start);
+
+        phase_start = start_profile_phase();
+        apply_pedestrian_movement();
+        end_profile_phase(PHASE_MOVEMENT, phase_start);
+
+        phase_start = start_profile_phase();
+        update_pedestrian_position_grid();
+        reset_pedestrian_state();
+        end_profile_phase(PHASE_GRID_UPDATE, phase_start);
+
+        timesteps++;
+
+        if(cli_args.heatmap_window > 0 && timesteps % cli_args.heatmap_window == 0)
+        {
+            if(close_heatmap_window(timesteps / cli_args.heatmap_window - 1) == FAILURE)
+                return FAILURE;
+        }
+
+        if(cli_args.output_format == OUTPUT_VISUALIZATION)
+        {
+            if(!cli_args.write_to_file)
+                sleep(1);
+                
+            print_complete_environment(output_file, simulation_index, timesteps);
+        }
+
+        if(is_dynamic_field_used)
+        {
+            phase_start = start_profile_phase();
+            apply_decay_and_diffusion();
+            end_profile_phase(PHASE_DIFFUSION, phase_start);
+        }
+
+        // The fire doesn't spread in timestep 0, since the timestep variable is incremented before
+        if(timesteps % fire_spread_interval == 0 && cli_args.fire_is_present)
+        {
+            phase_start = start_profile_phase();
+            if(spread_fire(&has_the_fire_spread) == FAILURE)
+                return FAILURE;
+            end_profile_phase(PHASE_FIRE_PROPAGATION, phase_start);
+        }
+
+        if(timesteps == cli_args.checkpoint_timestep && seed == checkpoint_seed && strcmp(cli_args.save_checkpoint_filename, "") != 0)
+        {
+            if(save_checkpoint(timesteps, has_the_fire_spread) == FAILURE)
+                return FAILURE;
+
+            was_checkpoint_saved = true;
+        }
+    }
+
+    if(seed == checkpoint_seed && strcmp(cli_args.save_checkpoint_filename, "") != 0 && ! was_checkpoint_saved)
+        fprintf(stderr, "The checkpoint wasn't saved, since the first simulation ended at timestep %d.\n", timesteps);
+
+    if(cli_args.heatmap_window > 0)
+    {
+        // Closes the last (possibly incomplete) window. If it was already closed, only zeroes are added to it.
+        if(close_heatmap_window(timesteps > 0 ? (timesteps - 1) / cli_args.heatmap_window : 0) == FAILURE)
+            return FAILURE;
+    }
+
+    if(origin_uses_static_pedestrians() == true)
+        reset_pedestrians_structures();
+    else
+        deallocate_pedestrians();
+
+    reset_exits();
+
+    flush_profile_counters();
+
+    if(run_statistics != NULL)
+    {
+        __atomic_add_fetch(&run_statistics->num_simulations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&run_statistics->timesteps, timesteps, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&run_statistics->pedestrian_steps, pedestrian_steps, __ATOMIC_RELAXED);
+    }
+
+    *number_timesteps = timesteps;
+
+    return SUCCESS;
+}
+
+/**
+ * Allocates the run statistics, in memory shared with the workers forked afterwards, so the simulations run by every process are counted.
+ * 
+ * @note Must be called before any simulation is run. If it isn't called, no statistics are collected.
+ * 
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status allocate_run_statistics()
+{
+    run_statistics = mmap(NULL, sizeof(Run_Statistics), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(run_statistics == MAP_FAILED)
+    {
+        perror("Failure to map the memory of the run statistics");
+        run_statistics = NULL;
+        return FAILURE;
+    }
+
+    *run_statistics = (Run_Statistics) {0, 0, 0};
+
+    return SUCCESS;
+}
+
+/**
+ * Prints the run statistics, as a single line of "name value" pairs, on the provided stream.
+ * 
+ * @param output_stream Stream where the data will be written.
+ */
+void print_run_statistics(FILE *output_stream)
+{
+    if(run_statistics == NULL)
+        return;
+
+    fprintf(output_stream, "simulations %lld timesteps %lld pedestrian_steps %lld\n", 
+            run_statistics->num_simulations, run_statistics->timesteps, run_statistics->pedestrian_steps);
+}
+
+/**
+ * Unmaps the run statistics, if they were allocated.
+ */
+void deallocate_run_statistics()
+{
+    if(run_statistics != NULL)
+        munmap(run_statistics, sizeof(Run_Statistics));
+
+    run_statistics = NULL;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Calls the necessary functions to identify and solve conflicts between pedestrians.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+*/
+static Function_Status conflict_solving()
+{
+    Cell_Conflict pedestrian_conflicts = NULL;
+    int num_conflicts = 0;
+
+    if(identify_pedestrian_conflicts(&pedestrian_conflicts, &num_conflicts) == FAILURE)
+        return FAILURE;                
+
+    if(solve_pedestrian_conflicts(pedestrian_conflicts, num_conflicts) == FAILURE)
+        return FAILURE;
+
+    if(cli_args.show_debug_information)
+        print_pedestrian_conflict_information(pedestrian_conflicts, num_conflicts);
+
+    free(pedestrian_conflicts);
+
+    return SUCCESS;
+}
+
+/**
+ * Captures the state of the simulation being run and writes it to the file given by --save-checkpoint.
+ * 
+ * @param timesteps Number of timesteps already run.
+ * @param has_the_fire_spread Whether the fire has spread in the last timestep.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status save_checkpoint(int timesteps, bool has_the_fire_spread)
+{
+    Simulation_State state = capture_simulation_state(timesteps, has_the_fire_spread);
+    if(state == NULL)
+        return FAILURE;
+
+    Function_Status status = write_simulation_state(state, cli_args.save_checkpoint_filename);
+    deallocate_simulation_state(state);
+
+    return status;
+}
@@ -11,10 +11,13 @@
 #include"../headers/fire_dynamics.h"
 #include"../headers/static_field.h"
 #include"../headers/exit.h"
+#include"../headers/cell_graph.h"
+#include"../headers/weight_cache.h"
 #include"../headers/shared_resources.h"
 
-static Function_Status calculate_static_weight(Exit current_exit);
 static void initialize_static_weight_grid(Exit current_exit);
+static bool set_non_walkable_cell(Field_Grid destination_grid, int line, int column);
+static void normalize_zheng_static_field(Field_Grid source_grid, Field_Grid destination_grid, double sum_of_all_distances);
 
 /**
  * Calculates the static floor field as described in Annex A of Kirchner's 2002 article.
@@ -23,25 +26,25 @@ static void initialize_static_weight_grid(Exit current_exit);
  * @param num_exit_cells The number of exit cells.
  * @param destination_grid The grid where the computed static field will be stored. If NULL is provided, the default will be exits_set.static_floor_field.
  */
-void calculate_kirchner_static_field(Location *exit_cell_coordinates, int num_exit_cells, Double_Grid destination_grid)
+void calculate_kirchner_static_field(Location *exit_cell_coordinates, int num_exit_cells, Field_Grid destination_grid)
 {
     if(destination_grid == NULL)
         destination_grid = exits_set.static_floor_field;
 
-    fill_double_grid(destination_grid, cli_args.global_line_number, cli_args.global_column_number, -1);
+    fill_field_grid(destination_grid, cli_args.global_line_number, cli_args.global_column_number, -1);
 
     double maximum_value = -1; // The maximum euclidean distance for any cell to an exit.
     for(int i = 0; i < cli_args.global_line_number; i++)
     {
         for(int j = 0; j < cli_args.global_column_number; j++)
         {
-            if(exits_only_grid[i][j] == EXIT_CELL)
+            if(cell_state_grid[i][j] & EXIT_STATE)
             {
                 destination_grid[i][j] = 0; // The distance of an exit_cell to itself is 0.
                 continue;
             }
 
-            if(obstacle_grid[i][j] == IMPASSABLE_OBJECT)
+            if(cell_state_grid[i][j] & WALL_STATE)
             {
                 destination_grid[i][j] = IMPASSABLE_OBJECT;
                 continue;
@@ -77,68 +80,107 @@ void calculate_kirchner_static_field(Location *exit_cell_coordinates, int num_ex
 /**
  * Calculates the static floor field as described in the Zheng's 2011 article.
  * 
+ * @note Only the cells of the walkable graph are calculated; every other cell is a wall or an obstacle.
+ * 
  * @param exit_cell_coordinates A list of all the valid exit cells.
  * @param num_exit_cells The number of exit cells.
  * @param destination_grid The grid where the computed static field will be stored. If NULL is provided, the default will be exits_set.static_floor_field.
  */
-void calculate_zheng_static_field(Location *exit_cell_coordinates, int num_exit_cells, Double_Grid destination_grid)
+void calculate_zheng_static_field(Location *exit_cell_coordinates, int num_exit_cells, Field_Grid destination_grid)
 {
     if(destination_grid == NULL)
         destination_grid = exits_set.static_floor_field;
 
-    fill_double_grid(destination_grid, cli_args.global_line_number, cli_args.global_column_number, -1);
+    fill_field_grid(destination_grid, cli_args.global_line_number, cli_args.global_column_number, IMPASSABLE_OBJECT);
 
     double sum_of_all_distances = 0;
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
     {
-        for(int j = 0; j < cli_args.global_column_number; j++)
+        int i = walkable_graph.cells[cell_index].lin;
+        int j = walkable_graph.cells[cell_index].col;
+
+        if(set_non_walkable_cell(destination_grid, i, j))
+            continue;
+
+        double nearest_distance = -1;
+        for(int exit_cell_index = 0; exit_cell_index < num_exit_cells; exit_cell_index++)
         {
-            if(exits_only_grid[i][j] != EXIT_CELL) // Exits cells must have their static field calculated
-            {
-                if(exits_only_grid[i][j] == BLOCKED_EXIT_CELL)
-                {
-                    destination_grid[i][j] = BLOCKED_EXIT_CELL;
-                    continue;
-                }
+            Location current_exit_cell = exit_cell_coordinates[exit_cell_index]; // The current exit cell being used as the reference.
+            double distance_to_exit = euclidean_distance(current_exit_cell, (Location) {i,j});
 
-                if(obstacle_grid[i][j] == IMPASSABLE_OBJECT)
-                {
-                    destination_grid[i][j] = IMPASSABLE_OBJECT;
-                    continue;
-                }
+            if(nearest_distance == -1 || distance_to_exit < nearest_distance)
+                nearest_distance = distance_to_exit;
+        }
 
-                if(fire_grid[i][j] == FIRE_CELL)
-                {
-                    destination_grid[i][j] = FIRE_CELL;
-                    continue;
-                }
-            }
+        // The plus one is used to avoid division by zero when calculating the floor field for an exit cell. Some tests to verify the best number to use may be good.
+        // IT'S NOT PRESENT IN THE ORIGINAL CALCULATION OF THE ZHENG FLOOR FIELD
+        destination_grid[i][j] = 1 / (nearest_distance + 1);
+        sum_of_all_distances += destination_grid[i][j];
+    }
 
-            for(int cell_index = 0; cell_index < num_exit_cells; cell_index++)
-            {
-                Location current_exit_cell = exit_cell_coordinates[cell_index]; // The current exit cell being used as the reference.
-                double distance_to_exit = euclidean_distance(current_exit_cell, (Location) {i,j});
+    normalize_zheng_static_field(destination_grid, destination_grid, sum_of_all_distances);
+}
 
-                if(destination_grid[i][j] == -1 || distance_to_exit < destination_grid[i][j])
-                    destination_grid[i][j] = distance_to_exit;
-            }
+/**
+ * Calculates the static floor field as described in the Zheng's 2011 article, considering every exit not blocked by fire.
+ * 
+ * @note Gives the same field as calculate_zheng_static_field over the cells of the non-blocked exits, but takes the distance
+ * of each cell from the nearest_distance_grid of the exits, so its cost grows with the number of exits instead of exit cells.
+ * The field is stored unnormalized, and its sum is kept in exits_set.static_field_normalizer, by which the cells are divided
+ * where they are read (see calculate_transition_probabilities). Thus remove_ignited_cells_from_zheng_static_field only
+ * changes the cells that catch fire.
+ * 
+ * @param destination_grid The grid where the computed static field will be stored. If NULL is provided, the default will be exits_set.static_floor_field.
+ */
+void compose_zheng_static_field(Field_Grid destination_grid)
+{
+    if(destination_grid == NULL)
+        destination_grid = exits_set.static_floor_field;
 
-            // The plus one is used to avoid division by zero when calculating the floor field for an exit cell. Some tests to verify the best number to use may be good.
-            // IT'S NOT PRESENT IN THE ORIGINAL CALCULATION OF THE ZHENG FLOOR FIELD
-            destination_grid[i][j] = 1 / (destination_grid[i][j] + 1);
-            sum_of_all_distances += destination_grid[i][j];
-        }
+    fill_field_grid(destination_grid, cli_args.global_line_number, cli_args.global_column_number, IMPASSABLE_OBJECT);
+
+    double sum_of_all_distances = 0;
+    for(int cell_index = 0; cell_index < walkable_graph.num_cells; cell_index++)
+    {
+        int i = walkable_graph.cells[cell_index].lin;
+        int j = walkable_graph.cells[cell_index].col;
+
+        if(set_non_walkable_cell(destination_grid, i, j))
+            continue;
+
+        destination_grid[i][j] = 1 / (distance_to_closest_non_blocked_exit(i, j) + 1); // See calculate_zheng_static_field.
+        sum_of_all_distances += destination_grid[i][j];
     }
 
-    for(int i = 0; i < cli_args.global_line_number; i++)
+    exits_set.static_field_normalizer = sum_of_all_distances;
+}
+
+/**
+ * Updates the static field composed by compose_zheng_static_field after the fire spreads to the current epoch, removing the
+ * cells that catch fire in it from the unnormalized field and from exits_set.static_field_normalizer. Only those cells are
+ * visited, since the field is normalized where it is read.
+ * 
+ * @note The distances to the exits don't change while no exit is blocked, so the field must only be composed again when
+ * check_for_exits_blocked_by_fire blocks an exit. The field must have been composed, or updated, for the previous epoch.
+ * 
+ * @param destination_grid The grid holding the static field to be updated. If NULL is provided, the default will be exits_set.static_floor_field.
+ */
+void remove_ignited_cells_from_zheng_static_field(Field_Grid destination_grid)
+{
+    if(destination_grid == NULL)
+        destination_grid = exits_set.static_floor_field;
+
+    int num_ignited_cells = 0;
+    const Location *ignited_cells = find_ignited_cells(current_fire_epoch, &num_ignited_cells);
+    for(int cell_index = 0; cell_index < num_ignited_cells; cell_index++)
     {
-        for(int j = 0; j < cli_args.global_column_number; j++)
-        {
-            if(destination_grid[i][j] == IMPASSABLE_OBJECT || destination_grid[i][j] == FIRE_CELL)
-                continue;
+        Location cell = ignited_cells[cell_index];
 
-            destination_grid[i][j] /= sum_of_all_distances;
-        }
+        if(cell_state_grid[cell.lin][cell.col] & ANY_EXIT_STATE)
+            continue; // Exit cells keep their static field, even with fire (see set_non_walkable_cell).
+
+        exits_set.static_field_normalizer -= destination_grid[cell.lin][cell.col];
+        destination_grid[cell.lin][cell.col] = FIRE_CELL;
     }
 }
 
@@ -160,15 +202,13 @@ Function_Status calculate_all_static_weights()
         Function_Status returned_status = calculate_static_weight(exits_set.list[exit_index]);
         if(returned_status != SUCCESS )
             return returned_status;
+
+        calculate_exit_distance_grid(exits_set.list[exit_index]);
     }
 
     return SUCCESS;
 }
 
-/* ---------------- ---------------- ---------------- ---------------- ---------------- */
-/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
-/* ---------------- ---------------- ---------------- ---------------- ---------------- */
-
 /**
  * Calculates the static weights for the given exit.
  * 
@@ -176,7 +216,7 @@ Function_Status calculate_all_static_weights()
  * 
  * @return Function_Status: FAILURE (0), SUCCESS (1) or INACCESSIBLE_EXIT(2).
 */
-static Function_Status calculate_static_weight(Exit current_exit)
+Function_Status calculate_static_weight(Exit current_exit)
 {
     double floor_field_rule[][3] = 
             {{cli_args.diagonal,    1.0,    cli_args.diagonal},
@@ -188,8 +228,17 @@ static Function_Status calculate_static_weight(Exit current_exit)
     if(is_exit_accessible(current_exit) == false)
         return INACCESSIBLE_EXIT;
 
-    Double_Grid varas_static_weight = current_exit->varas_static_weight;
-    Double_Grid auxiliary_grid = allocate_double_grid(cli_args.global_line_number,cli_args.global_column_number);
+    Field_Grid varas_static_weight = current_exit->varas_static_weight;
+
+    Static_Weight_Key cache_key = {0, 0};
+    if(cli_args.use_weight_cache)
+    {
+        cache_key = calculate_static_weight_key(varas_static_weight);
+        if(read_cached_static_weight(cache_key, varas_static_weight))
+            return SUCCESS;
+    }
+
+    Field_Grid auxiliary_grid = allocate_field_grid(cli_args.global_line_number,cli_args.global_column_number);
     // stores the chances for the timestep t + 1
 
     if(auxiliary_grid == NULL)
@@ -198,7 +247,7 @@ static Function_Status calculate_static_weight(Exit current_exit)
         return FAILURE;
     }
 
-    copy_double_grid(auxiliary_grid, varas_static_weight); // copies the base structure of the floor field
+    copy_field_grid(auxiliary_grid, varas_static_weight); // copies the base structure of the floor field
 
     bool has_changed;
     do
@@ -208,7 +257,7 @@ static Function_Status calculate_static_weight(Exit current_exit)
         {
             for(int h = 0; h < cli_args.global_column_number; h++)
             {
-                double current_cell_value = varas_static_weight[i][h];
+                Field_Value current_cell_value = varas_static_weight[i][h];
 
                 if(current_cell_value == IMPASSABLE_OBJECT || current_cell_value == 0.0) // floor field calculations occur only on cells with values
                     continue;
@@ -232,7 +281,7 @@ static Function_Status calculate_static_weight(Exit current_exit)
                                 continue;
                         }
 
-                        double adjacent_cell_value = current_cell_value + floor_field_rule[1 + j][1 + k];
+                        Field_Value adjacent_cell_value = current_cell_value + floor_field_rule[1 + j][1 + k];
                         if(auxiliary_grid[i + j][h + k] == 0.0)
                         {    
                             auxiliary_grid[i + j][h + k] = adjacent_cell_value;
@@ -247,16 +296,23 @@ static Function_Status calculate_static_weight(Exit current_exit)
                 }
             }
         }
-        copy_double_grid(varas_static_weight,auxiliary_grid); 
+        copy_field_grid(varas_static_weight,auxiliary_grid); 
         // make sure varas_static_weight now holds t + 1 timestep, allowing auxiliary_grid to hold t + 2 timestep.
     }
     while(has_changed);
 
     deallocate_grid((void **) auxiliary_grid, cli_args.global_line_number);
 
+    if(cli_args.use_weight_cache)
+        write_cached_static_weight(cache_key, varas_static_weight); // The cache is only an optimisation, so the weights are kept even if they can't be stored.
+
     return SUCCESS;
 }
 
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
 /**
  * Copies the structure (obstacles and walls) from the obstacle_grid to the static weight grid 
  * for the provided exit. Additionally, adds the exit cells to it.
@@ -285,4 +341,57 @@ static void initialize_static_weight_grid(Exit current_exit)
 
         current_exit->varas_static_weight[exit_cell.lin][exit_cell.col] = EXIT_CELL;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Sets the static field of the cells where pedestrians can't stand (blocked exits, walls and obstacles, and fire), which are
+ * marked with the corresponding constant instead of a value. Exit cells are never marked, since they have their static field calculated.
+ * 
+ * @param destination_grid The grid where the static field is being calculated.
+ * @param line Line of the cell.
+ * @param column Column of the cell.
+ * @return bool, where True indicates that the cell was marked, or False otherwise.
+ */
+static bool set_non_walkable_cell(Field_Grid destination_grid, int line, int column)
+{
+    uint8_t cell_state = cell_state_grid[line][column];
+
+    if(cell_state & EXIT_STATE)
+        return false;
+
+    if(cell_state & BLOCKED_EXIT_STATE)
+        destination_grid[line][column] = BLOCKED_EXIT_CELL;
+    else if(cell_state & WALL_STATE)
+        destination_grid[line][column] = IMPASSABLE_OBJECT;
+    else if(cell_state & FIRE_STATE)
+        destination_grid[line][column] = FIRE_CELL;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * Divides the static field of every cell, except walls, obstacles and fire, by the sum of the inverse distances.
+ * 
+ * @note Every cell of the destination grid is written, so the grid is traversed in a single pass instead of through the walkable graph.
+ * 
+ * @param source_grid The grid holding the inverse distances (may be the destination grid).
+ * @param destination_grid The grid where the normalized static field will be stored.
+ * @param sum_of_all_distances The sum of the inverse distances of every walkable cell.
+ */
+static void normalize_zheng_static_field(Field_Grid source_grid, Field_Grid destination_grid, double sum_of_all_distances)
+{
+    Field_Value normalizer = sum_of_all_distances; // The cells are divided in the precision of the grid (see Field_Value).
+
+    for(int i = 0; i < cli_args.global_line_number; i++)
+    {
+        for(int j = 0; j < cli_args.global_column_number; j++)
+        {
+            if(source_grid[i][j] == IMPASSABLE_OBJECT || source_grid[i][j] == FIRE_CELL)
+                destination_grid[i][j] = source_grid[i][j];
+            else
+                destination_grid[i][j] = source_grid[i][j] / normalizer;
+        }
+    }
+}
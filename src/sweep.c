@@ -0,0 +1,753 @@
+/*
+   File: sweep.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the sweep planner and scheduler. The planner determines the parameter points to be simulated, either from the constant varied with --min, --max and --step or from a sweep file (Cartesian or Latin hypercube sweeps over several constants). The scheduler runs every simulation of a simulation set (each point times each replica) as a single grid of jobs, reusing the fields prepared once for the set.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<limits.h>
+
+#include"../headers/sweep.h"
+#include"../headers/simulation.h"
+#include"../headers/worker_pool.h"
+#include"../headers/heatmap.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+#define MAX_SWEEP_PARAMETERS 7
+
+typedef struct{
+    const char *name;
+    double *constant; // The field of cli_args that holds the parameter.
+    double lower_limit; // Lowest valid value (inclusive).
+    double upper_limit; // Highest valid value (inclusive).
+}Sweepable_Constant;
+
+typedef struct{
+    const Sweepable_Constant *sweepable;
+    double min;
+    double max;
+    double step; // Only used by Cartesian sweeps.
+}Sweep_Parameter;
+
+// Constants that may be listed in a sweep file.
+static const Sweepable_Constant sweepable_constants[MAX_SWEEP_PARAMETERS] = {
+    {"ks", &cli_args.ks, 0, HUGE_VAL},
+    {"kd", &cli_args.kd, -HUGE_VAL, HUGE_VAL},
+    {"kf", &cli_args.kf, 0, HUGE_VAL},
+    {"omega", &cli_args.omega, 1, HUGE_VAL},
+    {"mu", &cli_args.mu, 0, 1},
+    {"fire_alpha", &cli_args.fire_alpha, 0, 1},
+    {"spread_rate", &cli_args.spread_rate, MIN_SPREAD_RATE, MAX_SPREAD_RATE}
+};
+
+const char *sweep_path = "sweeps/";
+
+static Function_Status simulation_set_job(int job_index, int *number_timesteps);
+static int schedule_next_round();
+static void update_point_convergence(int point_index, int *simulation_results);
+static void print_simulation_set_results(FILE *output_file, const int *simulation_results);
+static void free_scheduling_lists();
+static void apply_sweep_point(int point_index);
+static void print_sweep_point(FILE *output_file, int point_index);
+static Function_Status plan_single_constant_sweep();
+static Function_Status load_sweep_file();
+static Function_Status parse_sweep_parameter(char *line, int line_number, bool is_latin_hypercube);
+static Function_Status generate_cartesian_points();
+static Function_Status generate_latin_hypercube_points(int num_samples);
+static int count_values_in_range(double min, double max, double step);
+
+static Sweep_Parameter sweep_parameters[MAX_SWEEP_PARAMETERS];
+static int num_sweep_parameters = 0;
+static double *sweep_points = NULL; // num_sweep_points lines of num_sweep_parameters values, each line being a point to be simulated.
+static int num_sweep_points = 0;
+static bool uses_sweep_file = false; // If false, the sweep is over the constant given by obtain_varying_constant (if any).
+
+static FILE *sweep_output_file = NULL; // Stream where the visual output is written while the simulations run.
+static int first_seed = 0; // The seed of the first job of the simulation set.
+static int *scheduled_jobs = NULL; // Jobs (point * num_simulations + replica) of the round being run.
+static int *replicas_run = NULL; // Number of replicas of each point run so far.
+static int *replicas_used = NULL; // Number of replicas of each point whose results are reported, or 0 while the point hasn't converged.
+static Running_Statistics *point_statistics = NULL; // Running statistics of the replicas of each point checked so far by update_point_convergence.
+
+/**
+ * Determines the parameter points that every simulation set will simulate. If a sweep file was provided, the points are read
+ * (or sampled) from it; otherwise, the constant given by obtain_varying_constant varies from cli_args.min to cli_args.max, or
+ * a single point is used if no constant varies.
+ *
+ * @note Must be called once, after the command line arguments are parsed.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status plan_parameter_sweep()
+{
+    if(strcmp(cli_args.sweep_filename, "") != 0)
+        return load_sweep_file();
+
+    return plan_single_constant_sweep();
+}
+
+/**
+ * Runs all the simulations of the current simulation set, for every planned parameter point, printing generated data if appropriate.
+ *
+ * @note The fields that depend only on the simulation set are prepared once (see prepare_simulation_set). The jobs are then
+ * distributed among the workers; job (point, replica) uses the seed cli_args.seed + point * num_simulations + replica, which
+ * are the same seeds given by running the points one after the other.
+ *
+ * @note With --convergence, the jobs are scheduled in rounds, each point receiving more replicas until its results converge
+ * (see update_point_convergence). The number of replicas used doesn't depend on the number of workers.
+ *
+ * @param output_file Stream where the output data will be written.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+*/
+Function_Status run_simulation_set(FILE *output_file)
+{
+    double original_values[MAX_SWEEP_PARAMETERS];
+    int num_jobs = num_sweep_points * cli_args.num_simulations;
+
+    int *simulation_results = malloc(sizeof(int) * num_jobs);
+    int *round_results = malloc(sizeof(int) * num_jobs);
+    scheduled_jobs = malloc(sizeof(int) * num_jobs);
+    replicas_run = calloc(num_sweep_points, sizeof(int));
+    replicas_used = calloc(num_sweep_points, sizeof(int));
+    point_statistics = calloc(num_sweep_points, sizeof(Running_Statistics));
+    if(simulation_results == NULL || round_results == NULL || scheduled_jobs == NULL || replicas_run == NULL || replicas_used == NULL ||
+       point_statistics == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of simulation results.\n");
+        free(simulation_results);
+        free(round_results);
+        free_scheduling_lists();
+        return FAILURE;
+    }
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        original_values[param_index] = *sweep_parameters[param_index].sweepable->constant;
+
+    Function_Status status = prepare_simulation_set();
+
+    first_seed = cli_args.seed;
+    sweep_output_file = output_file;
+
+    if(status == SUCCESS && cli_args.output_format == OUTPUT_HEATMAP)
+    {
+        // The heatmap is printed once for the whole simulation set, preceded by the identification of every point.
+        for(int point_index = 0; point_index < num_sweep_points; point_index++)
+            print_sweep_point(output_file, point_index);
+    }
+
+    while(status == SUCCESS)
+    {
+        int num_round_jobs = schedule_next_round();
+        if(num_round_jobs == 0)
+            break; // Every point has converged or used all its replicas.
+
+        status = run_jobs(num_round_jobs, &simulation_set_job, round_results);
+
+        for(int round_index = 0; round_index < num_round_jobs && status == SUCCESS; round_index++)
+            simulation_results[scheduled_jobs[round_index]] = round_results[round_index];
+
+        for(int point_index = 0; point_index < num_sweep_points && status == SUCCESS; point_index++)
+            update_point_convergence(point_index, simulation_results);
+    }
+
+    cli_args.seed += num_jobs;
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        *sweep_parameters[param_index].sweepable->constant = original_values[param_index];
+
+    if(status == SUCCESS && cli_args.heatmap_window > 0)
+        status = close_heatmap_window(0); // Counts made by this process outside the simulations (e.g., static pedestrians being loaded) belong to the first window.
+
+    if(status == SUCCESS && cli_args.output_format == OUTPUT_TIMESTEPS_COUNT)
+        print_simulation_set_results(output_file, simulation_results);
+
+    fflush(output_file);
+    free(simulation_results);
+    free(round_results);
+    free_scheduling_lists();
+
+    return status;
+}
+
+/**
+ * Returns the number of simulations of each simulation set: one per planned point and replica.
+ *
+ * @return The number of simulations.
+ */
+int count_simulation_set_jobs()
+{
+    return num_sweep_points * cli_args.num_simulations;
+}
+
+/**
+ * Runs a single simulation of the current simulation set, for scheduling simulation sets out of order (see set_scheduler.c).
+ * The swept constants are restored afterwards.
+ *
+ * @note prepare_simulation_set must have been called for the current simulation set. Convergence isn't supported.
+ *
+ * @param set_job_index Index of the simulation within the simulation set (point * num_simulations + replica).
+ * @param set_first_seed Seed of the first simulation of the simulation set.
+ * @param number_timesteps Pointer to an integer, where the number of timesteps required by the simulation will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status run_simulation_set_job(int set_job_index, int set_first_seed, int *number_timesteps)
+{
+    double original_values[MAX_SWEEP_PARAMETERS];
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        original_values[param_index] = *sweep_parameters[param_index].sweepable->constant;
+
+    apply_sweep_point(set_job_index / cli_args.num_simulations);
+
+    Function_Status status = run_single_simulation(NULL, set_job_index % cli_args.num_simulations, set_first_seed + set_job_index, number_timesteps);
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        *sweep_parameters[param_index].sweepable->constant = original_values[param_index];
+
+    return status;
+}
+
+/**
+ * Prints the results of a simulation set whose simulations were run with run_simulation_set_job, exactly as run_simulation_set
+ * prints them in the timesteps output format.
+ *
+ * @param output_file Stream where the results will be written.
+ * @param set_first_seed Seed of the first simulation of the simulation set.
+ * @param simulation_results Results of the simulation set, indexed by point * num_simulations + replica.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status print_simulation_set_job_results(FILE *output_file, int set_first_seed, const int *simulation_results)
+{
+    replicas_used = malloc(sizeof(int) * num_sweep_points);
+    if(replicas_used == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of replicas used.\n");
+        return FAILURE;
+    }
+
+    for(int point_index = 0; point_index < num_sweep_points; point_index++)
+        replicas_used[point_index] = cli_args.num_simulations;
+
+    first_seed = set_first_seed;
+    print_simulation_set_results(output_file, simulation_results);
+    free_scheduling_lists();
+
+    return SUCCESS;
+}
+
+/**
+ * Deallocates the planned parameter points.
+ */
+void deallocate_sweep_points()
+{
+    free(sweep_points);
+    sweep_points = NULL;
+    num_sweep_points = 0;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Job function used by run_simulation_set: runs the replica of the point given by the scheduled_jobs list of the current round.
+ *
+ * @param job_index Index of the job within the current round.
+ * @param number_timesteps Pointer to an integer, where the number of timesteps required by the simulation will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status simulation_set_job(int job_index, int *number_timesteps)
+{
+    int set_job_index = scheduled_jobs[job_index]; // Index of the job within the whole simulation set.
+    int point_index = set_job_index / cli_args.num_simulations;
+    int simu_index = set_job_index % cli_args.num_simulations;
+
+    apply_sweep_point(point_index);
+
+    if(cli_args.output_format == OUTPUT_VISUALIZATION && simu_index == 0)
+        print_sweep_point(sweep_output_file, point_index);
+
+    return run_single_simulation(sweep_output_file, simu_index, first_seed + set_job_index, number_timesteps);
+}
+
+/**
+ * Lists, in scheduled_jobs, the jobs of the next round: the replicas that follow the ones already run, for every point whose results haven't converged.
+ *
+ * @note The first round runs cli_args.min_simulations replicas of each point (or all of them, if --convergence wasn't given). 
+ * The following rounds run one replica per worker for each point, so the workers remain busy even with few points left.
+ *
+ * @return The number of jobs in the round.
+ */
+static int schedule_next_round()
+{
+    int num_round_jobs = 0;
+
+    for(int point_index = 0; point_index < num_sweep_points; point_index++)
+    {
+        if(replicas_used[point_index] > 0)
+            continue; // Already converged.
+
+        int batch_size = cli_args.num_workers;
+        if(replicas_run[point_index] == 0)
+            batch_size = cli_args.convergence_tolerance > 0 ? cli_args.min_simulations : cli_args.num_simulations;
+
+        if(batch_size > cli_args.num_simulations - replicas_run[point_index])
+            batch_size = cli_args.num_simulations - replicas_run[point_index];
+
+        for(int batch_index = 0; batch_index < batch_size; batch_index++, num_round_jobs++)
+            scheduled_jobs[num_round_jobs] = point_index * cli_args.num_simulations + replicas_run[point_index] + batch_index;
+
+        replicas_run[point_index] += batch_size;
+    }
+
+    return num_round_jobs;
+}
+
+/**
+ * Verifies if the results of a point have converged, in which case replicas_used stores the number of replicas to be reported.
+ *
+ * @note The replicas are added to the running statistics of the point in order, each one only once (in the round where it
+ * is run), and the point converges at the first replica (not below 
+ * cli_args.min_simulations) where the half-width of the 95% confidence interval is at most cli_args.convergence_tolerance 
+ * times the mean. Replicas run after that one in the same round are discarded, so the result doesn't depend on the round sizes.
+ *
+ * @param point_index Index of the point.
+ * @param simulation_results Results of the simulation set, indexed by point * num_simulations + replica.
+ */
+static void update_point_convergence(int point_index, int *simulation_results)
+{
+    if(replicas_used[point_index] > 0)
+        return;
+
+    Running_Statistics *statistics = &point_statistics[point_index];
+    int *point_results = &simulation_results[point_index * cli_args.num_simulations];
+
+    for(int simu_index = statistics->count; simu_index < replicas_run[point_index]; simu_index++)
+    {
+        update_running_statistics(statistics, point_results[simu_index]);
+
+        if(cli_args.convergence_tolerance > 0 && statistics->count >= cli_args.min_simulations &&
+           calculate_confidence_half_width(statistics) <= cli_args.convergence_tolerance * statistics->mean)
+        {
+            replicas_used[point_index] = statistics->count;
+            return;
+        }
+    }
+
+    if(replicas_run[point_index] == cli_args.num_simulations)
+        replicas_used[point_index] = cli_args.num_simulations;
+}
+
+/**
+ * Prints the results of the used replicas of every point, in the timesteps output format.
+ *
+ * @param output_file Stream where the results will be written.
+ * @param simulation_results Results of the simulation set, indexed by point * num_simulations + replica.
+ */
+static void print_simulation_set_results(FILE *output_file, const int *simulation_results)
+{
+    if(uses_sweep_file)
+    {
+        // One line per (parameters, seed) result.
+        fprintf(output_file, "#");
+        for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+            fprintf(output_file, " %s", sweep_parameters[param_index].sweepable->name);
+        fprintf(output_file, " seed timesteps\n");
+    }
+
+    for(int point_index = 0; point_index < num_sweep_points; point_index++)
+    {
+        int first_job = point_index * cli_args.num_simulations;
+
+        if(uses_sweep_file)
+        {
+            for(int job_index = first_job; job_index < first_job + replicas_used[point_index]; job_index++)
+            {
+                for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+                    fprintf(output_file, "%.6f ", sweep_points[point_index * num_sweep_parameters + param_index]);
+
+                fprintf(output_file, "%d %d\n", first_seed + job_index, simulation_results[job_index]);
+            }
+
+            continue;
+        }
+
+        print_sweep_point(output_file, point_index);
+
+        if(cli_args.convergence_tolerance > 0)
+            fprintf(output_file, "[%d] ", replicas_used[point_index]);
+
+        for(int job_index = first_job; job_index < first_job + replicas_used[point_index]; job_index++)
+            fprintf(output_file,"%d ", simulation_results[job_index]);
+
+        if(num_sweep_parameters > 0)
+            fprintf(output_file, "\n");
+    }
+}
+
+/**
+ * Frees the lists used to schedule the jobs of a simulation set.
+ */
+static void free_scheduling_lists()
+{
+    free(scheduled_jobs);
+    free(replicas_run);
+    free(replicas_used);
+    free(point_statistics);
+    scheduled_jobs = replicas_run = replicas_used = NULL;
+    point_statistics = NULL;
+}
+
+/**
+ * Sets the swept constants to the values of the given point.
+ *
+ * @param point_index Index of the point.
+ */
+static void apply_sweep_point(int point_index)
+{
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        *sweep_parameters[param_index].sweepable->constant = sweep_points[point_index * num_sweep_parameters + param_index];
+}
+
+/**
+ * Prints the identification of a point before its results: "*VALUE " when a single constant varies from the command line,
+ * or "*NAME=VALUE ... " when the sweep comes from a sweep file. Nothing is printed if no constant varies.
+ *
+ * @param output_file Stream where the identification will be written.
+ * @param point_index Index of the point.
+ */
+static void print_sweep_point(FILE *output_file, int point_index)
+{
+    if(num_sweep_parameters == 0)
+        return;
+
+    if(! uses_sweep_file)
+    {
+        fprintf(output_file, "*%.3f ", sweep_points[point_index]);
+        return;
+    }
+
+    fprintf(output_file, "*");
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+        fprintf(output_file, "%s=%.6f ", sweep_parameters[param_index].sweepable->name, sweep_points[point_index * num_sweep_parameters + param_index]);
+}
+
+/**
+ * Plans the sweep over the constant given by obtain_varying_constant, or a single point if no constant varies.
+ *
+ * @note The values are accumulated exactly as a loop over the constant would, so they match the ones printed by older versions.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status plan_single_constant_sweep()
+{
+    static Sweepable_Constant varying; // Kirchner constants aren't in sweepable_constants, so a description is built here.
+
+    double *varying_constant = obtain_varying_constant();
+
+    num_sweep_parameters = 0;
+    num_sweep_points = 1;
+
+    if(varying_constant != NULL)
+    {
+        varying = (Sweepable_Constant) {"", varying_constant, -HUGE_VAL, HUGE_VAL};
+        sweep_parameters[0] = (Sweep_Parameter) {&varying, cli_args.min, cli_args.max, cli_args.step};
+        num_sweep_parameters = 1;
+
+        num_sweep_points = count_values_in_range(cli_args.min, cli_args.max, cli_args.step);
+        if(num_sweep_points == 0)
+        {
+            fprintf(stderr, "The interval [%.3f, %.3f] of the varying constant has no values.\n", cli_args.min, cli_args.max);
+            return FAILURE;
+        }
+    }
+
+    sweep_points = malloc(sizeof(double) * num_sweep_points * (num_sweep_parameters > 0 ? num_sweep_parameters : 1));
+    if(sweep_points == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of sweep points.\n");
+        return FAILURE;
+    }
+
+    double value = cli_args.min;
+    for(int point_index = 0; point_index < num_sweep_points; point_index++, value += cli_args.step)
+        sweep_points[point_index] = value;
+
+    return SUCCESS;
+}
+
+/**
+ * Reads the sweep file given by --sweep-file and generates its points.
+ *
+ * @note The first non-comment line selects the sweep type ("cartesian" or "latin-hypercube SAMPLES"). Each following line
+ * holds a constant and its range: "NAME MIN MAX STEP" for Cartesian sweeps and "NAME MIN MAX" for Latin hypercube sweeps.
+ * Lines starting with '#' are ignored.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status load_sweep_file()
+{
+    char complete_path[300] = "";
+    char line[300];
+    char sweep_type[31] = "";
+    int num_samples = 0;
+    int line_number = 0;
+
+    sprintf(complete_path, "%s%s", sweep_path, cli_args.sweep_filename);
+
+    FILE *sweep_file = fopen(complete_path, "r");
+    if(sweep_file == NULL)
+    {
+        fprintf(stderr, "It was not possible to open the sweep file.\n");
+        return FAILURE;
+    }
+
+    uses_sweep_file = true;
+    num_sweep_parameters = 0;
+
+    while(fgets(line, sizeof(line), sweep_file) != NULL)
+    {
+        line_number++;
+
+        char first_token[31] = "";
+        if(sscanf(line, "%30s", first_token) != 1 || first_token[0] == '#')
+            continue; // Blank line or comment.
+
+        if(strcmp(sweep_type, "") == 0)
+        {
+            strcpy(sweep_type, first_token);
+
+            if(strcmp(sweep_type, "latin-hypercube") == 0)
+            {
+                if(sscanf(line, "%*s %d", &num_samples) != 1 || num_samples <= 0)
+                {
+                    fprintf(stderr, "Sweep file, line %d: a positive number of samples must follow latin-hypercube.\n", line_number);
+                    fclose(sweep_file);
+                    return FAILURE;
+                }
+            }
+            else if(strcmp(sweep_type, "cartesian") != 0)
+            {
+                fprintf(stderr, "Sweep file, line %d: unknown sweep type '%s' (expected cartesian or latin-hypercube).\n", line_number, sweep_type);
+                fclose(sweep_file);
+                return FAILURE;
+            }
+
+            continue;
+        }
+
+        if(parse_sweep_parameter(line, line_number, num_samples > 0) == FAILURE)
+        {
+            fclose(sweep_file);
+            return FAILURE;
+        }
+    }
+
+    fclose(sweep_file);
+
+    if(num_sweep_parameters == 0)
+    {
+        fprintf(stderr, "The sweep file doesn't list any constant.\n");
+        return FAILURE;
+    }
+
+    if(num_samples > 0)
+        return generate_latin_hypercube_points(num_samples);
+
+    return generate_cartesian_points();
+}
+
+/**
+ * Parses a line of the sweep file that describes a constant and its range, appending it to sweep_parameters.
+ *
+ * @param line The line.
+ * @param line_number Number of the line, used in error messages.
+ * @param is_latin_hypercube Whether the sweep is a Latin hypercube (no step is given) or a Cartesian one.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status parse_sweep_parameter(char *line, int line_number, bool is_latin_hypercube)
+{
+    char name[31] = "";
+    Sweep_Parameter parameter = {NULL, 0, 0, 0};
+    int expected_fields = is_latin_hypercube ? 3 : 4;
+
+    if(sscanf(line, "%30s %lf %lf %lf", name, &parameter.min, &parameter.max, &parameter.step) != expected_fields)
+    {
+        fprintf(stderr, "Sweep file, line %d: expected '%s'.\n", line_number, is_latin_hypercube ? "NAME MIN MAX" : "NAME MIN MAX STEP");
+        return FAILURE;
+    }
+
+    for(int index = 0; index < MAX_SWEEP_PARAMETERS; index++)
+    {
+        if(strcmp(name, sweepable_constants[index].name) == 0)
+            parameter.sweepable = &sweepable_constants[index];
+    }
+
+    if(parameter.sweepable == NULL)
+    {
+        fprintf(stderr, "Sweep file, line %d: '%s' can't be swept (valid constants are ks, kd, kf, omega, mu, fire_alpha and spread_rate).\n", line_number, name);
+        return FAILURE;
+    }
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+    {
+        if(sweep_parameters[param_index].sweepable == parameter.sweepable)
+        {
+            fprintf(stderr, "Sweep file, line %d: '%s' is listed more than once.\n", line_number, name);
+            return FAILURE;
+        }
+    }
+
+    if(parameter.min > parameter.max)
+    {
+        fprintf(stderr, "Sweep file, line %d: the minimum value of '%s' must be lower than its maximum value.\n", line_number, name);
+        return FAILURE;
+    }
+
+    if(parameter.min < parameter.sweepable->lower_limit || parameter.max > parameter.sweepable->upper_limit)
+    {
+        fprintf(stderr, "Sweep file, line %d: the range of '%s' exceeds its valid values.\n", line_number, name);
+        return FAILURE;
+    }
+
+    if(! is_latin_hypercube && parameter.step <= 0)
+    {
+        fprintf(stderr, "Sweep file, line %d: the step value of '%s' must be a positive number.\n", line_number, name);
+        return FAILURE;
+    }
+
+    sweep_parameters[num_sweep_parameters] = parameter;
+    num_sweep_parameters++;
+
+    return SUCCESS;
+}
+
+/**
+ * Generates every combination of the values of the swept constants. The last constant of the sweep file varies fastest.
+ *
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status generate_cartesian_points()
+{
+    int num_values[MAX_SWEEP_PARAMETERS];
+
+    long total_points = num_sweep_parameters > 0 ? 1 : 0;
+    for(int param_index = 0; param_index < num_sweep_parameters && total_points > 0; param_index++)
+    {
+        Sweep_Parameter *parameter = &sweep_parameters[param_index];
+        num_values[param_index] = count_values_in_range(parameter->min, parameter->max, parameter->step);
+        total_points *= num_values[param_index];
+
+        if(total_points > INT_MAX / cli_args.num_simulations)
+            break;
+    }
+
+    if(total_points <= 0 || total_points > INT_MAX / cli_args.num_simulations)
+    {
+        fprintf(stderr, "The cartesian product of the sweep file is empty or has too many points.\n");
+        return FAILURE;
+    }
+    num_sweep_points = total_points;
+
+    sweep_points = malloc(sizeof(double) * num_sweep_points * num_sweep_parameters);
+    if(sweep_points == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of sweep points.\n");
+        return FAILURE;
+    }
+
+    for(int point_index = 0; point_index < num_sweep_points; point_index++)
+    {
+        int remainder = point_index;
+        for(int param_index = num_sweep_parameters - 1; param_index >= 0; param_index--)
+        {
+            int value_index = remainder % num_values[param_index];
+            remainder /= num_values[param_index];
+
+            sweep_points[point_index * num_sweep_parameters + param_index] =
+                sweep_parameters[param_index].min + value_index * sweep_parameters[param_index].step;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Samples the points of a Latin hypercube: the range of each constant is split in num_samples strata of equal width, and
+ * each stratum is used by exactly one point, at a random position within it.
+ *
+ * @note The random number generator is seeded with cli_args.seed, so the same seed always samples the same points.
+ *
+ * @param num_samples Number of points to be sampled.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status generate_latin_hypercube_points(int num_samples)
+{
+    if(num_samples > INT_MAX / cli_args.num_simulations)
+    {
+        fprintf(stderr, "The Latin hypercube of the sweep file has too many samples for %d simulations per point.\n", cli_args.num_simulations);
+        return FAILURE;
+    }
+    num_sweep_points = num_samples;
+
+    sweep_points = malloc(sizeof(double) * num_sweep_points * num_sweep_parameters);
+    int *strata = malloc(sizeof(int) * num_samples);
+    if(sweep_points == NULL || strata == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of sweep points.\n");
+        free(strata);
+        return FAILURE;
+    }
+
+    srand(cli_args.seed);
+
+    for(int param_index = 0; param_index < num_sweep_parameters; param_index++)
+    {
+        Sweep_Parameter *parameter = &sweep_parameters[param_index];
+        double stratum_width = (parameter->max - parameter->min) / num_samples;
+
+        for(int sample = 0; sample < num_samples; sample++)
+            strata[sample] = sample;
+
+        for(int sample = num_samples - 1; sample > 0; sample--) // Fisher-Yates shuffle of the strata.
+        {
+            int chosen = rand() % (sample + 1);
+            int aux = strata[sample];
+            strata[sample] = strata[chosen];
+            strata[chosen] = aux;
+        }
+
+        for(int sample = 0; sample < num_samples; sample++)
+        {
+            double offset = rand() / ((double) RAND_MAX + 1);
+            sweep_points[sample * num_sweep_parameters + param_index] = parameter->min + (strata[sample] + offset) * stratum_width;
+        }
+    }
+
+    free(strata);
+
+    return SUCCESS;
+}
+
+/**
+ * Counts the values from min to max (inclusive, up to TOLERANCE) in increments of step.
+ *
+ * @param min First value.
+ * @param max Last possible value.
+ * @param step Increment between consecutive values.
+ * @return The number of values.
+ */
+static int count_values_in_range(double min, double max, double step)
+{
+    int count = 0;
+
+    for(double value = min; value <= max + TOLERANCE; value += step)
+        count++;
+
+    return count;
+}
@@ -0,0 +1,193 @@
+/*
+   File: weight_cache.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the persistent cache of static weights (enabled with --weight-cache). The static weights of an exit depend only on the environment structure, the exit cells, the diagonal value and the corner movement, so they are stored in the cache directory, in a binary file named after an FNV-1a hash of those inputs, and copied back (from a read-only mapping of the file) into the static weight grid of the exit whenever the same exit appears again, in this or in a later run. The header of each file holds a second, independent hash of the same inputs, together with the dimensions, the diagonal value and the corner movement, which are all checked before the weights are used, so a collision of the file names can't load the weights of another exit.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<unistd.h>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+#include"../headers/weight_cache.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+#define CACHE_IDENTIFIER "ZHENGSWC"
+#define CACHE_VERSION 2
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define CHECK_MULTIPLIER 0x9E3779B97F4A7C15ULL // 2^64 divided by the golden ratio, used by the check hash.
+
+// Header of a cache file. The weights follow it, line after line.
+typedef struct{
+    char identifier[8];
+    int version;
+    int line_number;
+    int column_number;
+    int prevent_corner_crossing;
+    double diagonal;
+    uint64_t key;
+    uint64_t check; // Second hash of the inputs of the key (see Static_Weight_Key).
+}Cache_Header;
+
+const char *cache_path = "cache/";
+
+static void add_key_bytes(Static_Weight_Key *key, const void *bytes, size_t size);
+static void build_cache_file_path(char *complete_path, uint64_t key);
+
+/**
+ * Calculates the key of the static weights of an exit: an FNV-1a hash (which names the cache file) and an independent check
+ * hash of its initial static weight grid (which holds the obstacles and the exit cells), the environment dimensions, the
+ * diagonal value and the corner movement option. The grid is hashed as stored, so the programs built with float and double
+ * fields (see Field_Value) never share a cache file.
+ *
+ * @param initial_static_weight Static weight grid of the exit, before the weights are calculated.
+ * @return The key.
+ */
+Static_Weight_Key calculate_static_weight_key(Field_Grid initial_static_weight)
+{
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+    int version = CACHE_VERSION;
+    int prevent_corner_crossing = cli_args.prevent_corner_crossing;
+
+    Static_Weight_Key key = {FNV_OFFSET_BASIS, 0};
+    add_key_bytes(&key, &version, sizeof(version));
+    add_key_bytes(&key, &cli_args.global_line_number, sizeof(cli_args.global_line_number));
+    add_key_bytes(&key, &cli_args.global_column_number, sizeof(cli_args.global_column_number));
+    add_key_bytes(&key, initial_static_weight[0], num_cells * sizeof(Field_Value));
+    add_key_bytes(&key, &cli_args.diagonal, sizeof(cli_args.diagonal));
+    add_key_bytes(&key, &prevent_corner_crossing, sizeof(prevent_corner_crossing));
+
+    return key;
+}
+
+/**
+ * Copies the static weights stored with the given key into the grid, if they are in the cache and the header of their file
+ * matches the key, the environment dimensions, the diagonal value and the corner movement option.
+ *
+ * @param key Key of the static weights (see calculate_static_weight_key).
+ * @param static_weight Grid where the static weights will be stored.
+ * @return True, if the static weights were found and read, or False otherwise (the grid is left unchanged).
+ */
+bool read_cached_static_weight(Static_Weight_Key key, Field_Grid static_weight)
+{
+    char complete_path[300] = "";
+    struct stat file_information;
+    size_t weights_size = (size_t) cli_args.global_line_number * cli_args.global_column_number * sizeof(Field_Value);
+
+    build_cache_file_path(complete_path, key.hash);
+
+    int cache_descriptor = open(complete_path, O_RDONLY);
+    if(cache_descriptor == -1)
+        return false;
+
+    if(fstat(cache_descriptor, &file_information) == -1 || (size_t) file_information.st_size != sizeof(Cache_Header) + weights_size)
+    {
+        close(cache_descriptor);
+        return false;
+    }
+
+    void *mapping = mmap(NULL, file_information.st_size, PROT_READ, MAP_PRIVATE, cache_descriptor, 0);
+    close(cache_descriptor);
+    if(mapping == MAP_FAILED)
+        return false;
+
+    const Cache_Header *header = mapping;
+    bool is_valid = memcmp(header->identifier, CACHE_IDENTIFIER, sizeof(header->identifier)) == 0 &&
+                    header->version == CACHE_VERSION && header->key == key.hash && header->check == key.check &&
+                    header->line_number == cli_args.global_line_number && header->column_number == cli_args.global_column_number &&
+                    header->diagonal == cli_args.diagonal && header->prevent_corner_crossing == cli_args.prevent_corner_crossing;
+
+    if(is_valid)
+        memcpy(static_weight[0], (const char *) mapping + sizeof(Cache_Header), weights_size);
+
+    munmap(mapping, file_information.st_size);
+
+    return is_valid;
+}
+
+/**
+ * Stores the static weights in the cache, with the given key.
+ *
+ * @note The file is written under a temporary name and then renamed, so programs sharing the cache never read an incomplete file.
+ * A failure (e.g., a missing cache directory or a full disk) is reported as a warning, since the weights only stay uncached.
+ *
+ * @param key Key of the static weights (see calculate_static_weight_key).
+ * @param static_weight Grid holding the static weights.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status write_cached_static_weight(Static_Weight_Key key, Field_Grid static_weight)
+{
+    char complete_path[300] = "";
+    char temporary_path[320] = "";
+    size_t num_cells = (size_t) cli_args.global_line_number * cli_args.global_column_number;
+
+    Cache_Header header = {.version = CACHE_VERSION, .line_number = cli_args.global_line_number,
+                           .column_number = cli_args.global_column_number, .prevent_corner_crossing = cli_args.prevent_corner_crossing,
+                           .diagonal = cli_args.diagonal, .key = key.hash, .check = key.check};
+    memcpy(header.identifier, CACHE_IDENTIFIER, sizeof(header.identifier));
+
+    build_cache_file_path(complete_path, key.hash);
+    sprintf(temporary_path, "%s.%d", complete_path, (int) getpid());
+
+    FILE *cache_file = fopen(temporary_path, "wb");
+    if(cache_file == NULL)
+    {
+        fprintf(stderr, "Warning: it was not possible to open the cache file %s for writing. The static weights won't be cached.\n", temporary_path);
+        return FAILURE;
+    }
+
+    bool was_written = fwrite(&header, sizeof(Cache_Header), 1, cache_file) == 1 &&
+                       fwrite(static_weight[0], sizeof(Field_Value), num_cells, cache_file) == num_cells;
+    if(fclose(cache_file) != 0 || ! was_written || rename(temporary_path, complete_path) != 0)
+    {
+        fprintf(stderr, "Warning: failure while writing the cache file %s. The static weights won't be cached.\n", complete_path);
+        remove(temporary_path);
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Adds the given bytes to both hashes of a key: the FNV-1a hash and the check hash, a multiplicative hash whose high bits are
+ * folded back after every byte.
+ *
+ * @param key The key of the previous bytes ({FNV_OFFSET_BASIS, 0}, for the first ones), which will be updated.
+ * @param bytes The bytes to be added.
+ * @param size Number of bytes.
+ */
+static void add_key_bytes(Static_Weight_Key *key, const void *bytes, size_t size)
+{
+    const unsigned char *current_byte = bytes;
+
+    for(size_t byte_index = 0; byte_index < size; byte_index++)
+    {
+        key->hash ^= current_byte[byte_index];
+        key->hash *= FNV_PRIME;
+
+        key->check = (key->check + current_byte[byte_index] + 1) * CHECK_MULTIPLIER;
+        key->check ^= key->check >> 32;
+    }
+}
+
+/**
+ * Writes the path of the cache file of the given key.
+ *
+ * @param complete_path String where the path will be written.
+ * @param key FNV-1a hash of the key of the static weights.
+ */
+static void build_cache_file_path(char *complete_path, uint64_t key)
+{
+    sprintf(complete_path, "%s%016llx.bin", cache_path, (unsigned long long) key);
+}
@@ -0,0 +1,408 @@
+/*
+   File: worker_pool.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains functions to divide independent jobs (such as the simulations of a simulation set) among worker processes. Each worker is a fork of the main process, so it owns a private copy of every grid and structure; the only synchronization while the jobs run is the distribution of the job indices, which the workers steal from each other once their own ones are over.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<signal.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/wait.h>
+
+#include"../headers/worker_pool.h"
+#include"../headers/heatmap.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+#define PROGRESS_INTERVAL 2000 // Microseconds between the checks of the finished jobs, when a progress function is given.
+
+// Jobs still owned by a worker: the next one in the high half of range and the end (exclusive) in the low half, so the owner
+// taking a job and a thief stealing part of them are both a single compare-and-swap.
+typedef struct{
+    uint64_t range;
+    char padding[56]; // Keeps each queue in its own cache line.
+}Job_Queue;
+
+// Memory shared between the main process and the workers.
+typedef struct{
+    Job_Queue *queues; // One per worker.
+    int *results;
+    unsigned char *is_finished; // Set, after the result is stored, when a job is finished.
+    size_t size;
+}Shared_Jobs;
+
+static Function_Status run_jobs_sequentially(int num_jobs, Job_Function job, int *job_results, Progress_Function progress);
+static Function_Status map_shared_jobs(Shared_Jobs *shared, int num_jobs, int num_workers);
+static Function_Status follow_progress(Shared_Jobs shared, int num_jobs, Progress_Function progress, pid_t *worker_ids, int *exit_statuses, int num_workers);
+static void run_worker(int worker_index, int num_workers, Job_Function job, Shared_Jobs shared, int write_descriptor);
+static int take_next_job(Job_Queue *queues, int worker_index, int num_workers);
+static int steal_jobs(Job_Queue *queues, int worker_index, int num_workers);
+static uint64_t pack_range(uint64_t next_job, uint64_t end);
+
+/**
+ * Runs all jobs, storing the result of each one at job_results[job_index]. If workers are enabled, the jobs are divided among 
+ * cli_args.num_workers processes; otherwise, they are run, in order, by the calling process.
+ * 
+ * @note The heatmap counted by each worker is private to it. After all jobs are done, the heatmaps of all workers are summed to the heatmap of the main process.
+ * 
+ * @param num_jobs Number of jobs to be run.
+ * @param job Function that runs a single job.
+ * @param job_results Array, with num_jobs positions, where the results will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status run_jobs(int num_jobs, Job_Function job, int *job_results)
+{
+    return run_jobs_with_progress(num_jobs, job, job_results, NULL);
+}
+
+/**
+ * Runs all jobs, as run_jobs does, calling progress in the main process whenever more of the first jobs are finished.
+ * 
+ * @note Each worker starts with a contiguous block of jobs and, once its block is over, steals half of the jobs left in the
+ * largest block of another worker, so jobs of very different durations still keep every worker busy. The jobs are finished
+ * in any order, but progress always receives the number of jobs finished from the first one on, so the results may be 
+ * reported in the order of the jobs while the remaining ones run.
+ * 
+ * @param num_jobs Number of jobs to be run.
+ * @param job Function that runs a single job.
+ * @param job_results Array, with num_jobs positions, where the results will be stored.
+ * @param progress Function called with the results finished so far, or NULL.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status run_jobs_with_progress(int num_jobs, Job_Function job, int *job_results, Progress_Function progress)
+{
+    int num_workers = cli_args.num_workers < num_jobs ? cli_args.num_workers : num_jobs;
+
+    if(! are_workers_enabled() || num_workers <= 1)
+        return run_jobs_sequentially(num_jobs, job, job_results, progress);
+
+    Shared_Jobs shared;
+    if(map_shared_jobs(&shared, num_jobs, num_workers) == FAILURE)
+        return FAILURE;
+
+    int *read_descriptors = malloc(sizeof(int) * num_workers);
+    pid_t *worker_ids = malloc(sizeof(pid_t) * num_workers);
+    int *exit_statuses = malloc(sizeof(int) * num_workers); // -1 while the worker wasn't waited for.
+    if(read_descriptors == NULL || worker_ids == NULL || exit_statuses == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the worker lists.\n");
+        free(read_descriptors);
+        free(worker_ids);
+        free(exit_statuses);
+        munmap(shared.queues, shared.size);
+        return FAILURE;
+    }
+
+    fflush(NULL); // Otherwise, the data buffered by the main process would be written again by every worker.
+
+    Function_Status status = SUCCESS;
+    int num_started_workers = 0;
+    for(; num_started_workers < num_workers; num_started_workers++)
+    {
+        int descriptors[2];
+        if(pipe(descriptors) == -1)
+        {
+            perror("Failure to create the pipe of a worker");
+            status = FAILURE;
+            break;
+        }
+
+        pid_t worker_id = fork();
+        if(worker_id == -1)
+        {
+            perror("Failure to create a worker");
+            close(descriptors[0]);
+            close(descriptors[1]);
+            status = FAILURE;
+            break;
+        }
+
+        if(worker_id == 0)
+        {
+            close(descriptors[0]);
+            for(int previous = 0; previous < num_started_workers; previous++)
+                close(read_descriptors[previous]);
+
+            run_worker(num_started_workers, num_workers, job, shared, descriptors[1]);
+        }
+
+        close(descriptors[1]);
+        read_descriptors[num_started_workers] = descriptors[0];
+        worker_ids[num_started_workers] = worker_id;
+        exit_statuses[num_started_workers] = -1;
+    }
+
+    if(status == SUCCESS && progress != NULL)
+        status = follow_progress(shared, num_jobs, progress, worker_ids, exit_statuses, num_started_workers);
+
+    for(int worker_index = 0; worker_index < num_started_workers; worker_index++)
+    {
+        bool was_stopped = status == FAILURE && exit_statuses[worker_index] == -1;
+        if(was_stopped)
+            kill(worker_ids[worker_index], SIGTERM); // Its remaining jobs are useless.
+
+        if(status == SUCCESS && read_and_reduce_heatmap_data(read_descriptors[worker_index]) == FAILURE)
+            status = FAILURE;
+
+        close(read_descriptors[worker_index]);
+
+        int exit_status = exit_statuses[worker_index];
+        if(exit_status == -1 && waitpid(worker_ids[worker_index], &exit_status, 0) == -1)
+            exit_status = -1;
+
+        if(! was_stopped && (exit_status == -1 || ! WIFEXITED(exit_status) || WEXITSTATUS(exit_status) != EXIT_SUCCESS))
+        {
+            fprintf(stderr, "The worker %d didn't finish its jobs successfully.\n", worker_index);
+            status = FAILURE;
+        }
+    }
+
+    if(status == SUCCESS)
+        memcpy(job_results, shared.results, sizeof(int) * num_jobs);
+
+    free(read_descriptors);
+    free(worker_ids);
+    free(exit_statuses);
+    munmap(shared.queues, shared.size);
+
+    return status;
+}
+
+/**
+ * Verifies if the jobs can be divided among workers. The visual output and the debug information are printed while the 
+ * simulations run, so, in order to keep them readable, both are only produced by the main process.
+ * 
+ * @return bool, where True indicates that the workers can be used and False otherwise.
+ */
+bool are_workers_enabled()
+{
+    return cli_args.num_workers > 1 && 
+           cli_args.output_format != OUTPUT_VISUALIZATION && 
+           cli_args.show_debug_information == false;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Runs all jobs, in order, in the calling process.
+ * 
+ * @param num_jobs Number of jobs to be run.
+ * @param job Function that runs a single job.
+ * @param job_results Array where the results will be stored.
+ * @param progress Function called after each job, or NULL.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status run_jobs_sequentially(int num_jobs, Job_Function job, int *job_results, Progress_Function progress)
+{
+    for(int job_index = 0; job_index < num_jobs; job_index++)
+    {
+        if(job(job_index, &(job_results[job_index])) == FAILURE)
+            return FAILURE;
+
+        if(progress != NULL && progress(job_index + 1, job_results) == FAILURE)
+            return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Maps the memory shared with the workers and divides the jobs in contiguous blocks, one per worker.
+ * 
+ * @param shared Structure where the shared lists will be stored.
+ * @param num_jobs Number of jobs.
+ * @param num_workers Number of workers.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status map_shared_jobs(Shared_Jobs *shared, int num_jobs, int num_workers)
+{
+    size_t queues_size = sizeof(Job_Queue) * num_workers;
+    size_t results_size = sizeof(int) * num_jobs;
+
+    shared->size = queues_size + results_size + num_jobs;
+    shared->queues = mmap(NULL, shared->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shared->queues == MAP_FAILED)
+    {
+        perror("Failure to map the memory shared with the workers");
+        return FAILURE;
+    }
+
+    shared->results = (int *) ((char *) shared->queues + queues_size);
+    shared->is_finished = (unsigned char *) shared->results + results_size; // The mapping starts zeroed.
+
+    for(int worker_index = 0; worker_index < num_workers; worker_index++)
+    {
+        uint64_t first_job = (uint64_t) num_jobs * worker_index / num_workers;
+        uint64_t end = (uint64_t) num_jobs * (worker_index + 1) / num_workers;
+        shared->queues[worker_index].range = pack_range(first_job, end);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Calls progress whenever more of the first jobs are finished, until all jobs are finished or a worker fails.
+ * 
+ * @param shared Memory shared with the workers.
+ * @param num_jobs Number of jobs.
+ * @param progress Function called with the results finished so far.
+ * @param worker_ids Process identifiers of the workers.
+ * @param exit_statuses Where the exit status of each worker that terminates is stored (-1 for the ones still running).
+ * @param num_workers Number of workers.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status follow_progress(Shared_Jobs shared, int num_jobs, Progress_Function progress, pid_t *worker_ids, int *exit_statuses, int num_workers)
+{
+    int num_finished_jobs = 0;
+
+    while(num_finished_jobs < num_jobs)
+    {
+        int previous_finished_jobs = num_finished_jobs;
+        while(num_finished_jobs < num_jobs && __atomic_load_n(&shared.is_finished[num_finished_jobs], __ATOMIC_ACQUIRE))
+            num_finished_jobs++;
+
+        if(num_finished_jobs > previous_finished_jobs)
+        {
+            if(progress(num_finished_jobs, shared.results) == FAILURE)
+                return FAILURE;
+
+            continue;
+        }
+
+        for(int worker_index = 0; worker_index < num_workers; worker_index++)
+        {
+            if(exit_statuses[worker_index] == -1 && waitpid(worker_ids[worker_index], &exit_statuses[worker_index], WNOHANG) <= 0)
+            {
+                exit_statuses[worker_index] = -1; // Still running.
+                continue;
+            }
+
+            if(! WIFEXITED(exit_statuses[worker_index]) || WEXITSTATUS(exit_statuses[worker_index]) != EXIT_SUCCESS)
+                return FAILURE; // Its jobs would never be finished.
+        }
+
+        usleep(PROGRESS_INTERVAL);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * The body of a worker process. The worker runs jobs, from its own block or stolen from the other workers, until none is 
+ * left, sends its heatmap to the main process and terminates.
+ * 
+ * @note This function never returns.
+ * 
+ * @param worker_index Index of the worker.
+ * @param num_workers Number of workers.
+ * @param job Function that runs a single job.
+ * @param shared Memory shared with the main process and the other workers.
+ * @param write_descriptor Write end of the pipe connected to the main process.
+ */
+static void run_worker(int worker_index, int num_workers, Job_Function job, Shared_Jobs shared, int write_descriptor)
+{
+    clear_heatmap_data(); // The counts inherited from the main process must not be sent back to it.
+
+    int job_index = 0;
+    while((job_index = take_next_job(shared.queues, worker_index, num_workers)) != -1)
+    {
+        if(job(job_index, &(shared.results[job_index])) == FAILURE)
+            _exit(EXIT_FAILURE);
+
+        __atomic_store_n(&shared.is_finished[job_index], 1, __ATOMIC_RELEASE);
+    }
+
+    if(write_heatmap_data(write_descriptor) == FAILURE)
+        _exit(EXIT_FAILURE);
+
+    close(write_descriptor);
+    _exit(EXIT_SUCCESS);
+}
+
+/**
+ * Takes the next job of the worker's own block or, if it is over, steals some from another worker.
+ * 
+ * @param queues Job queues of all workers.
+ * @param worker_index Index of the worker.
+ * @param num_workers Number of workers.
+ * @return The index of the job, or -1 if every job was already taken.
+ */
+static int take_next_job(Job_Queue *queues, int worker_index, int num_workers)
+{
+    uint64_t *own_range = &queues[worker_index].range;
+    uint64_t range = __atomic_load_n(own_range, __ATOMIC_ACQUIRE);
+
+    while((range >> 32) < (range & UINT32_MAX))
+    {
+        if(__atomic_compare_exchange_n(own_range, &range, range + ((uint64_t) 1 << 32), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return (int) (range >> 32);
+    }
+
+    return steal_jobs(queues, worker_index, num_workers);
+}
+
+/**
+ * Steals the second half of the jobs left in the largest block of the other workers. The first stolen job is returned and 
+ * the others become the worker's own block.
+ * 
+ * @note The worker's own block must be over.
+ * 
+ * @param queues Job queues of all workers.
+ * @param worker_index Index of the thief.
+ * @param num_workers Number of workers.
+ * @return The index of the job, or -1 if every job was already taken.
+ */
+static int steal_jobs(Job_Queue *queues, int worker_index, int num_workers)
+{
+    while(true)
+    {
+        int victim_index = -1;
+        uint64_t victim_range = 0;
+        uint64_t largest_size = 0;
+
+        for(int other_index = 0; other_index < num_workers; other_index++)
+        {
+            uint64_t range = __atomic_load_n(&queues[other_index].range, __ATOMIC_ACQUIRE);
+            uint64_t next_job = range >> 32, end = range & UINT32_MAX;
+
+            if(other_index != worker_index && next_job < end && end - next_job > largest_size)
+            {
+                victim_index = other_index;
+                victim_range = range;
+                largest_size = end - next_job;
+            }
+        }
+
+        if(victim_index == -1)
+            return -1;
+
+        uint64_t end = victim_range & UINT32_MAX;
+        uint64_t first_stolen = end - (largest_size + 1) / 2;
+
+        if(__atomic_compare_exchange_n(&queues[victim_index].range, &victim_range, pack_range(victim_range >> 32, first_stolen), 
+                                       false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            __atomic_store_n(&queues[worker_index].range, pack_range(first_stolen + 1, end), __ATOMIC_RELEASE);
+            return (int) first_stolen;
+        }
+    }
+}
+
+/**
+ * Packs a block of jobs in the format of Job_Queue.range.
+ * 
+ * @param next_job Index of the next job of the block.
+ * @param end Index after the last job of the block.
+ * @return The packed block.
+ */
+static uint64_t pack_range(uint64_t next_job, uint64_t end)
+{
+    return (next_job << 32) | end;
+}
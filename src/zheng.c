@@ -0,0 +1,743 @@
+/*
+   File: zheng.c
+   Author: Daniel Gonçalves
+   Date: 2026-10-16
+   Description: This module contains the in-process interface to the model (libzheng). A context holds an environment, read from a memory buffer, to which exits are added and whose parameters are set by name; each run simulates a number of replicas with consecutive seeds, returning the evacuation times through an array and/or a callback. A context may also be created from command line arguments, in which case it runs the simulation sets they describe, as the zheng program does. The model state is global, so a single context may exist at a time.
+*/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<limits.h>
+#include<argp.h>
+
+#include"../headers/zheng.h"
+#include"../headers/exit.h"
+#include"../headers/initialization.h"
+#include"../headers/static_field.h"
+#include"../headers/simulation.h"
+#include"../headers/worker_pool.h"
+#include"../headers/heatmap.h"
+#include"../headers/fire_field.h"
+#include"../headers/checkpoint.h"
+#include"../headers/sweep.h"
+#include"../headers/profiling.h"
+#include"../headers/door_combinations.h"
+#include"../headers/set_scheduler.h"
+#include"../headers/printing_utilities.h"
+#include"../headers/cli_processing.h"
+#include"../headers/shared_resources.h"
+
+typedef enum{
+    PARAMETER_DOUBLE,
+    PARAMETER_INTEGER,
+    PARAMETER_BOOLEAN
+}Parameter_Type;
+
+typedef struct{
+    const char *name;
+    Parameter_Type type;
+    void *field; // The field of cli_args that holds the parameter.
+    double lower_limit; // Lowest valid value (inclusive).
+    double upper_limit; // Highest valid value (inclusive).
+    bool changes_static_weights; // If true, the static weights of the exits must be calculated again after a change.
+}Model_Parameter;
+
+struct zheng_context{
+    bool are_static_weights_valid; // False after the exits, or the parameters they depend on, change.
+    bool has_inaccessible_exit; // Result of the last calculation of the static weights.
+    bool is_from_arguments; // Created by zheng_create_context_from_arguments.
+    FILE *output_file; // Stream where the output of zheng_run_simulation_sets is written.
+    FILE *auxiliary_file; // File where the simulation sets are stored, or NULL if the exits are static.
+    int simulation_set_quantity; // Number of simulation sets of zheng_run_simulation_sets.
+};
+
+#define NUM_MODEL_PARAMETERS 17
+
+// Parameters that may be set with zheng_set_parameter. The limits are the same enforced by the command line options.
+static const Model_Parameter model_parameters[NUM_MODEL_PARAMETERS] = {
+    {"ks", PARAMETER_DOUBLE, &cli_args.ks, 0, HUGE_VAL, false},
+    {"kd", PARAMETER_DOUBLE, &cli_args.kd, -HUGE_VAL, HUGE_VAL, false},
+    {"kf", PARAMETER_DOUBLE, &cli_args.kf, 0, HUGE_VAL, false},
+    {"alpha", PARAMETER_DOUBLE, &cli_args.alpha, 0, 1, false},
+    {"delta", PARAMETER_DOUBLE, &cli_args.delta, 0, 1, false},
+    {"omega", PARAMETER_DOUBLE, &cli_args.omega, 1, HUGE_VAL, false},
+    {"mu", PARAMETER_DOUBLE, &cli_args.mu, 0, 1, false},
+    {"fire_alpha", PARAMETER_DOUBLE, &cli_args.fire_alpha, 0, 1, false},
+    {"fire_gamma", PARAMETER_DOUBLE, &cli_args.fire_gamma, 0, HUGE_VAL, false},
+    {"risk_distance", PARAMETER_DOUBLE, &cli_args.risk_distance, 0, HUGE_VAL, false},
+    {"spread_rate", PARAMETER_DOUBLE, &cli_args.spread_rate, MIN_SPREAD_RATE, MAX_SPREAD_RATE, false},
+    {"density", PARAMETER_DOUBLE, &cli_args.density, 0, 1, false},
+    {"pedestrians", PARAMETER_INTEGER, &cli_args.total_num_pedestrians, 1, INT_MAX, false},
+    {"workers", PARAMETER_INTEGER, &cli_args.num_workers, 1, INT_MAX, false},
+    {"diagonal", PARAMETER_DOUBLE, &cli_args.diagonal, 0, HUGE_VAL, true},
+    {"avoid_corner_movement", PARAMETER_BOOLEAN, &cli_args.prevent_corner_crossing, 0, 1, true},
+    {"immediate_exit", PARAMETER_BOOLEAN, &cli_args.immediate_exit, 0, 1, false}
+};
+
+static void restore_default_arguments();
+static Function_Status prepare_arguments_context(Zheng_Context context);
+static Function_Status run_simulation_sets_in_order(Zheng_Context context);
+static Function_Status update_static_weights(Zheng_Context context);
+static Function_Status replica_job(int job_index, int *number_timesteps);
+
+static Zheng_Context current_context = NULL;
+static Command_Line_Args default_arguments;
+static bool were_default_arguments_saved = false;
+static int run_first_seed = 0; // Seed of the first replica of the run in progress.
+
+/**
+ * Creates a context, reading the environment from the given buffer, in the format of the files in the environments directory.
+ * Every parameter starts with the default value of the corresponding command line option.
+ *
+ * @note Only a single context may exist at a time, since the model state is global.
+ *
+ * @param environment Buffer holding the environment.
+ * @param environment_length Length, in bytes, of the buffer.
+ * @param environment_origin How the environment symbols are interpreted (see the --origin option). AUTOMATIC_CREATED isn't supported.
+ * @return The new context, or NULL on failure.
+ */
+Zheng_Context zheng_create_context(const char *environment, size_t environment_length, enum Environment_Origin environment_origin)
+{
+    if(current_context != NULL)
+    {
+        fprintf(stderr, "A context already exists. It must be destroyed before another one is created.\n");
+        return NULL;
+    }
+
+    if(environment_origin < ONLY_STRUCTURE || environment_origin >= AUTOMATIC_CREATED)
+    {
+        fprintf(stderr, "The environment origin %d isn't supported by contexts.\n", environment_origin);
+        return NULL;
+    }
+
+    restore_default_arguments();
+
+    cli_args.environment_origin = environment_origin;
+    cli_args.output_format = OUTPUT_TIMESTEPS_COUNT;
+
+    Zheng_Context new_context = calloc(1, sizeof(struct zheng_context));
+    if(new_context == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the context.\n");
+        return NULL;
+    }
+
+    FILE *environment_stream = fmemopen((void *) environment, environment_length, "r");
+    if(environment_stream == NULL)
+    {
+        perror("Failure to open the environment buffer");
+        free(new_context);
+        return NULL;
+    }
+
+    initialize_random_state();
+
+    Function_Status status = read_environment(environment_stream);
+    fclose(environment_stream);
+    if(status == FAILURE)
+    {
+        deallocate_environment();
+        free(new_context);
+        return NULL;
+    }
+
+    if(initialize_simulation_constants() == FAILURE)
+    {
+        deallocate_environment();
+        free(new_context);
+        return NULL;
+    }
+
+    current_context = new_context;
+
+    return new_context;
+}
+
+/**
+ * Creates a context from command line arguments (see cli_processing.c), as the zheng program does: the environment is read from
+ * its file (or generated), the output and auxiliary files are opened and the parameter sweep is planned. The simulation sets
+ * described by the arguments are run by zheng_run_simulation_sets.
+ *
+ * @note The arguments are parsed with argp, so the program ends if they are invalid or if --help is given.
+ *
+ * @param argc Number of arguments.
+ * @param argv The arguments, the first being the program name.
+ * @return The new context, or NULL on failure.
+ */
+Zheng_Context zheng_create_context_from_arguments(int argc, char **argv)
+{
+    if(current_context != NULL)
+    {
+        fprintf(stderr, "A context already exists. It must be destroyed before another one is created.\n");
+        return NULL;
+    }
+
+    restore_default_arguments();
+    initialize_random_state();
+
+    if(argp_parse(&argp, argc, argv, 0, 0, &cli_args) != 0)
+        return NULL;
+
+    Zheng_Context new_context = calloc(1, sizeof(struct zheng_context));
+    if(new_context == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the context.\n");
+        return NULL;
+    }
+
+    new_context->is_from_arguments = true;
+    new_context->simulation_set_quantity = 1; // Origins that use static exits have a single simulation set.
+    current_context = new_context;
+
+    if(prepare_arguments_context(new_context) == FAILURE)
+    {
+        zheng_destroy_context(new_context);
+        return NULL;
+    }
+
+    return new_context;
+}
+
+/**
+ * Runs every simulation set described by the command line arguments of the context, writing their results to the output file,
+ * and prints the run statistics (if requested).
+ *
+ * @param context A context created by zheng_create_context_from_arguments.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status zheng_run_simulation_sets(Zheng_Context context)
+{
+    if(context == NULL || context != current_context || ! context->is_from_arguments)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    Function_Status status;
+    if(is_set_scheduling_enabled())
+        status = run_all_simulation_sets(context->output_file, context->auxiliary_file, context->simulation_set_quantity);
+    else
+        status = run_simulation_sets_in_order(context);
+
+    if(status == SUCCESS)
+        print_run_statistics(stderr);
+
+    return status;
+}
+
+/**
+ * Sets the parameter with the given name (ks, kd, kf, alpha, delta, omega, mu, fire_alpha, fire_gamma, risk_distance, spread_rate,
+ * density, pedestrians, workers, diagonal, avoid_corner_movement or immediate_exit).
+ *
+ * @note Setting the density makes the number of pedestrians inserted depend on it, while setting the pedestrians fixes that number.
+ * Both are ignored by origins with pedestrians in the environment.
+ *
+ * @param context The context.
+ * @param name Name of the parameter.
+ * @param value New value of the parameter. Integer and boolean (0 or 1) parameters must be given whole values.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status zheng_set_parameter(Zheng_Context context, const char *name, double value)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    for(int param_index = 0; param_index < NUM_MODEL_PARAMETERS; param_index++)
+    {
+        const Model_Parameter *parameter = &model_parameters[param_index];
+        if(strcmp(parameter->name, name) != 0)
+            continue;
+
+        if(value < parameter->lower_limit || value > parameter->upper_limit ||
+           (parameter->type != PARAMETER_DOUBLE && value != floor(value)))
+        {
+            fprintf(stderr, "The value %g is invalid for the parameter %s.\n", value, name);
+            return FAILURE;
+        }
+
+        if(parameter->type == PARAMETER_DOUBLE)
+            *(double *) parameter->field = value;
+        else if(parameter->type == PARAMETER_INTEGER)
+            *(int *) parameter->field = (int) value;
+        else
+            *(bool *) parameter->field = value != 0;
+
+        if(strcmp(name, "density") == 0)
+            cli_args.use_density = true;
+        else if(strcmp(name, "pedestrians") == 0)
+            cli_args.use_density = false;
+
+        if(parameter->changes_static_weights)
+            context->are_static_weights_valid = false;
+
+        return SUCCESS;
+    }
+
+    fprintf(stderr, "Unknown parameter %s.\n", name);
+    return FAILURE;
+}
+
+/**
+ * Adds an exit, formed by the given cells, to the environment.
+ *
+ * @param context The context.
+ * @param exit_cells Coordinates of the cells of the exit.
+ * @param num_exit_cells Number of cells of the exit.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status zheng_add_exit(Zheng_Context context, const Location *exit_cells, int num_exit_cells)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    if(exit_cells == NULL || num_exit_cells <= 0)
+    {
+        fprintf(stderr, "An exit must have at least one cell.\n");
+        return FAILURE;
+    }
+
+    for(int cell_index = 0; cell_index < num_exit_cells; cell_index++)
+    {
+        Location cell = exit_cells[cell_index];
+        if(cell.lin < 0 || cell.lin >= cli_args.global_line_number || cell.col < 0 || cell.col >= cli_args.global_column_number)
+        {
+            fprintf(stderr, "The exit cell (%d,%d) is outside the environment.\n", cell.lin, cell.col);
+            return FAILURE;
+        }
+    }
+
+    if(add_new_exit(exit_cells[0]) == FAILURE)
+        return FAILURE;
+
+    Exit new_exit = exits_set.list[exits_set.num_exits - 1];
+    for(int cell_index = 1; cell_index < num_exit_cells; cell_index++)
+    {
+        if(expand_exit(new_exit, exit_cells[cell_index]) == FAILURE)
+            return FAILURE;
+    }
+
+    for(int cell_index = 0; cell_index < num_exit_cells; cell_index++)
+        cell_state_grid[exit_cells[cell_index].lin][exit_cells[cell_index].col] |= EXIT_STATE;
+
+    if(set_private_grid_data(new_exit) == FAILURE)
+        return FAILURE;
+
+    context->are_static_weights_valid = false;
+
+    return SUCCESS;
+}
+
+/**
+ * Removes every exit from the environment, including those read from it.
+ *
+ * @param context The context.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+Function_Status zheng_clear_exits(Zheng_Context context)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    deallocate_exits();
+
+    clear_cell_state_flags(cell_state_grid, ANY_EXIT_STATE);
+
+    context->are_static_weights_valid = false;
+
+    return SUCCESS;
+}
+
+/**
+ * Runs num_replicas simulations with the current exits and parameters. Replica i uses the seed first_seed + i, so the results
+ * are the same whatever the number of workers.
+ *
+ * @note The static weights of the exits are only calculated again when the exits, the diagonal or the corner movement change.
+ *
+ * @param context The context.
+ * @param num_replicas Number of simulations to be run.
+ * @param first_seed Seed of the first replica.
+ * @param timesteps Array, with num_replicas positions, where the evacuation time of each replica is stored. May be NULL.
+ * @param callback Function called with the result of each replica, in order, after all of them are run. May be NULL.
+ * @param user_data Pointer given to the callback.
+ * @return Function_Status: FAILURE (0), SUCCESS (1) or INACCESSIBLE_EXIT (2), if an exit can't be reached, in which case no
+ * simulation is run.
+ */
+Function_Status zheng_run(Zheng_Context context, int num_replicas, int first_seed, int *timesteps, Zheng_Replica_Callback callback, void *user_data)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    if(num_replicas <= 0 || first_seed < 0)
+    {
+        fprintf(stderr, "The number of replicas must be positive and the first seed non-negative.\n");
+        return FAILURE;
+    }
+
+    Function_Status status = update_static_weights(context);
+    if(status != SUCCESS)
+        return status;
+
+    if(prepare_simulation_set() == FAILURE)
+        return FAILURE;
+
+    int *replica_results = malloc(sizeof(int) * num_replicas);
+    if(replica_results == NULL)
+    {
+        fprintf(stderr, "Failure to allocate the list of replica results.\n");
+        return FAILURE;
+    }
+
+    clear_heatmap_data(); // The heatmap only counts the pedestrians of the last run.
+
+    run_first_seed = first_seed;
+    status = run_jobs(num_replicas, &replica_job, replica_results);
+
+    if(status == SUCCESS)
+    {
+        for(int replica_index = 0; replica_index < num_replicas; replica_index++)
+        {
+            if(timesteps != NULL)
+                timesteps[replica_index] = replica_results[replica_index];
+
+            if(callback != NULL)
+                callback(replica_index, first_seed + replica_index, replica_results[replica_index], user_data);
+        }
+    }
+
+    free(replica_results);
+
+    return status;
+}
+
+/**
+ * Returns the cells of one of the grids of the model, stored line after line, without copying them.
+ *
+ * @note The floor fields are only allocated by the first run after the exits are set, and are deallocated when the exits are
+ * cleared. After a run, they hold the values at the end of the last replica run by the calling process (with workers, the
+ * replicas run in other processes, so the fields hold their values at the beginning of the simulations). The heatmap holds the
+ * pedestrian counts of every replica of the last run.
+ *
+ * @note The model keeps the static floor field unnormalized (see compose_zheng_static_field). It is returned as it is stored;
+ * each cell, except walls, obstacles and fire, must be divided by zheng_get_static_field_normalizer to obtain the normalized field.
+ *
+ * @param context The context.
+ * @param field The grid to be returned.
+ * @param num_lines Pointer to an integer, where the number of lines of the grid will be stored.
+ * @param num_columns Pointer to an integer, where the number of columns of the grid will be stored.
+ * @return Pointer to the first cell of the grid (a Field_Value, see grid.h, or an int for the heatmap), or NULL if it isn't allocated.
+ */
+void *zheng_get_field(Zheng_Context context, Zheng_Field field, int *num_lines, int *num_columns)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return NULL;
+    }
+
+    void **grid = NULL;
+    switch(field)
+    {
+        case ZHENG_STATIC_FLOOR_FIELD:
+            grid = (void **) exits_set.static_floor_field;
+            break;
+        case ZHENG_DYNAMIC_FLOOR_FIELD:
+            grid = (void **) exits_set.dynamic_floor_field;
+            break;
+        case ZHENG_FIRE_FLOOR_FIELD:
+            grid = (void **) exits_set.fire_floor_field;
+            break;
+        case ZHENG_FIRE_DISTANCE_GRID:
+            grid = (void **) fire_distance_grid;
+            break;
+        case ZHENG_HEATMAP_GRID:
+            grid = (void **) heatmap_grid;
+            break;
+        default:
+            fprintf(stderr, "Unknown field %d.\n", field);
+            return NULL;
+    }
+
+    if(grid == NULL)
+        return NULL;
+
+    *num_lines = cli_args.global_line_number;
+    *num_columns = cli_args.global_column_number;
+
+    return grid[0]; // The cells of every grid are stored in a single block (see allocate_integer_grid).
+}
+
+/**
+ * Obtains the sum by which the static floor field returned by zheng_get_field must be divided to be normalized.
+ *
+ * @note Like the field, the sum is updated by every run: the cells that catch fire are removed from it, so it may reach 0.
+ *
+ * @param context The context.
+ * @param normalizer Pointer to a double, where the sum will be stored.
+ * @return Function_Status: FAILURE (0), if the context is invalid or the static floor field isn't allocated, or SUCCESS (1).
+ */
+Function_Status zheng_get_static_field_normalizer(Zheng_Context context, double *normalizer)
+{
+    if(context == NULL || context != current_context)
+    {
+        fprintf(stderr, "Invalid context.\n");
+        return FAILURE;
+    }
+
+    if(exits_set.static_floor_field == NULL)
+        return FAILURE;
+
+    *normalizer = exits_set.static_field_normalizer;
+
+    return SUCCESS;
+}
+
+/**
+ * Destroys the context, deallocating the environment and every structure derived from it. The files opened for a context
+ * created from command line arguments are closed.
+ *
+ * @param context The context. Nothing is done if it is NULL.
+ */
+void zheng_destroy_context(Zheng_Context context)
+{
+    if(context == NULL || context != current_context)
+        return;
+
+    if(context->auxiliary_file != NULL)
+        fclose(context->auxiliary_file);
+
+    if(context->output_file != NULL && context->output_file != stdout)
+        fclose(context->output_file);
+
+    if(cli_args.door_combination_size > 0)
+        deallocate_door_combinations();
+
+    deallocate_environment();
+    deallocate_sweep_points();
+    deallocate_run_statistics();
+    deallocate_profile_counters();
+
+    free(context);
+    current_context = NULL;
+}
+
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+/* ---------------- ---------------- STATIC FUNCTIONS ---------------- ---------------- */
+/* ---------------- ---------------- ---------------- ---------------- ---------------- */
+
+/**
+ * Restores the arguments to their default values, so nothing set for a previous context is kept. The defaults are saved when
+ * the first context is created.
+ */
+static void restore_default_arguments()
+{
+    if(were_default_arguments_saved)
+        cli_args = default_arguments;
+    else
+    {
+        default_arguments = cli_args;
+        were_default_arguments_saved = true;
+    }
+}
+
+/**
+ * Opens the files of a context created from command line arguments, loads (or generates) its environment, plans the parameter
+ * sweep and counts the simulation sets.
+ *
+ * @param context The context.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status prepare_arguments_context(Zheng_Context context)
+{
+    if(open_auxiliary_file(&context->auxiliary_file) == FAILURE)
+        return FAILURE;
+
+    if(open_output_file(&context->output_file) == FAILURE)
+        return FAILURE;
+    print_full_command(context->output_file);
+
+    if(cli_args.environment_origin != AUTOMATIC_CREATED)
+    {
+        if(load_environment() == FAILURE)
+            return FAILURE;
+    }
+    else
+    {
+        if(generate_environment() == FAILURE)
+            return FAILURE;
+    }
+    if(initialize_simulation_constants() == FAILURE)
+        return FAILURE;
+
+    if(cli_args.print_run_statistics && allocate_run_statistics() == FAILURE)
+        return FAILURE;
+
+    if(cli_args.profile && allocate_profile_counters() == FAILURE)
+        return FAILURE;
+
+    if(plan_parameter_sweep() == FAILURE)
+        return FAILURE;
+
+    if(cli_args.door_combination_size > 0)
+    {
+        if(load_candidate_doors(context->auxiliary_file) == FAILURE)
+            return FAILURE;
+
+        context->simulation_set_quantity = count_door_combinations();
+        if(context->simulation_set_quantity == -1)
+            return FAILURE;
+    }
+    else if(context->auxiliary_file != NULL)
+    {
+        context->simulation_set_quantity = extract_simulation_set_quantity(context->auxiliary_file);
+        if(context->simulation_set_quantity == -1)
+            return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Runs the simulation sets of a context created from command line arguments one after the other, printing the results of each
+ * one after its simulations.
+ *
+ * @param context The context.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status run_simulation_sets_in_order(Zheng_Context context)
+{
+    FILE *output_file = context->output_file;
+    int simulation_set_index = 0;
+    int current_exit_number = 0;
+
+    do
+    {
+        if(cli_args.door_combination_size > 0)
+        {
+            if(get_next_door_combination(&current_exit_number) == FAILURE)
+                return FAILURE;
+
+            if(current_exit_number == 0)
+                break; // All door combinations were processed.
+        }
+        else if(origin_uses_auxiliary_data() == true)
+        {
+            if( get_next_simulation_set(context->auxiliary_file, &current_exit_number) == FAILURE)
+                return FAILURE;
+
+            if(current_exit_number == 0)
+                break; // All simulation sets were processed.
+        }
+
+        if(cli_args.show_simulation_set_info)
+            print_simulation_set_information(output_file);
+
+        int returned_value = cli_args.door_combination_size > 0 ? check_door_combination_accessibility() : calculate_all_static_weights();
+        if( returned_value == FAILURE) 
+            return FAILURE;
+        else if(returned_value == INACCESSIBLE_EXIT)
+        {
+            if(cli_args.output_format != OUTPUT_TIMESTEPS_COUNT)
+                fprintf(output_file, "At least one exit from the simulation set is inaccessible.\n");
+            else
+                print_placeholder(output_file, -1);
+
+            if(cli_args.door_combination_size > 0)
+                release_door_combination();
+            else if(origin_uses_auxiliary_data() == true)
+                deallocate_exits();
+
+            print_execution_status(simulation_set_index, context->simulation_set_quantity);
+            simulation_set_index++;
+
+            continue;
+        }
+
+        if(allocate_exits_set_fields() == FAILURE)
+            return FAILURE;
+
+        if(cli_args.single_exit_flag == true && exits_set.num_exits == 1 && cli_args.output_format == OUTPUT_TIMESTEPS_COUNT)
+            fprintf(output_file, "#1 "); 
+            // Simulation set where the exit was combined with itself. This is used to correct errors in the plotting program.
+
+        if(run_simulation_set(output_file) == FAILURE) // The simulations actually happen here.
+            return FAILURE;
+
+        if(report_simulation_set_profile(simulation_set_index) == FAILURE)
+            return FAILURE;
+
+        if(cli_args.door_combination_size > 0)
+            release_door_combination();
+        else if(origin_uses_auxiliary_data() == true)
+            deallocate_exits();
+
+        if(cli_args.output_format == OUTPUT_TIMESTEPS_COUNT)
+            fprintf(output_file, "\n");
+
+        if(cli_args.output_format == OUTPUT_HEATMAP)
+        {
+            print_heatmap(output_file);        
+            clear_heatmap_data();
+        }     
+
+        print_execution_status(simulation_set_index, context->simulation_set_quantity);
+        simulation_set_index++;
+
+        if(origin_uses_static_exits() == true) // Only a single simulation set.
+            break;
+    }while(true);
+
+    return SUCCESS;
+}
+
+/**
+ * Calculates the static weights of the exits, if they changed since the last calculation, and allocates the exits set fields.
+ *
+ * @param context The context.
+ * @return Function_Status: FAILURE (0), SUCCESS (1) or INACCESSIBLE_EXIT (2).
+ */
+static Function_Status update_static_weights(Zheng_Context context)
+{
+    if(! context->are_static_weights_valid)
+    {
+        Function_Status status = calculate_all_static_weights();
+        if(status == FAILURE)
+            return FAILURE;
+
+        context->has_inaccessible_exit = status == INACCESSIBLE_EXIT;
+        context->are_static_weights_valid = true;
+    }
+
+    if(context->has_inaccessible_exit)
+        return INACCESSIBLE_EXIT;
+
+    if(exits_set.static_floor_field == NULL && allocate_exits_set_fields() == FAILURE)
+        return FAILURE;
+
+    return SUCCESS;
+}
+
+/**
+ * Runs a single replica of the run in progress.
+ *
+ * @param job_index Index of the replica.
+ * @param number_timesteps Pointer to an integer, where the number of timesteps required by the simulation will be stored.
+ * @return Function_Status: FAILURE (0) or SUCCESS (1).
+ */
+static Function_Status replica_job(int job_index, int *number_timesteps)
+{
+    return run_single_simulation(NULL, job_index, run_first_seed + job_index, number_timesteps);
+}
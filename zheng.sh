@@ -1,3 +1,3 @@
 #!/bin/bash
 
-gcc -o build/zheng.exe src/*.c -lm -g && ./build/zheng.exe "$@"
\ No newline at end of file
+make -s release && ./build/release/zheng.exe "$@"
\ No newline at end of file